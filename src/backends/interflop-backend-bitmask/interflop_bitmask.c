@@ -59,6 +59,7 @@
 typedef enum {
   KEY_PREC_B32,
   KEY_PREC_B64,
+  KEY_MASK_REUSE,
   KEY_MODE = 'm',
   KEY_OPERATOR = 'o',
   KEY_SEED = 's',
@@ -76,6 +77,7 @@ static const char key_operator_str[] = "operator";
 static const char key_seed_str[] = "seed";
 static const char key_daz_str[] = "daz";
 static const char key_ftz_str[] = "ftz";
+static const char key_mask_reuse_str[] = "mask-reuse";
 
 /* string name of the bitmask modes */
 static const char *const BITMASK_MODE_STR[] = {[bitmask_mode_ieee] = "ieee",
@@ -183,6 +185,14 @@ static void _set_bitmask_ftz(bool ftz, bitmask_context_t *ctx) {
   ctx->ftz = ftz;
 }
 
+static void _set_bitmask_mask_reuse(int mask_reuse, bitmask_context_t *ctx) {
+  if (mask_reuse <= 0) {
+    logger_error("--%s invalid value provided, must be a positive integer.",
+                 key_mask_reuse_str);
+  }
+  ctx->mask_reuse = mask_reuse;
+}
+
 static void _set_bitmask_seed(uint64_t seed, bitmask_context_t *ctx) {
   ctx->seed = seed;
   ctx->choose_seed = true;
@@ -211,20 +221,46 @@ void bitmask_push_seed(uint64_t seed) {
 /* Function used by Verrou to restore the copied rng state */
 void bitmask_pop_seed() { rng_state = __rng_state; }
 
-static uint64_t get_random_mask() {
+/* last random mask drawn and number of draws it still serves */
+static TLS uint64_t reused_mask = 0;
+static TLS int reused_mask_count = 0;
+
+/* Returns a 64-bits random mask, drawing a new one only every
+ * ctx->mask_reuse calls */
+static uint64_t get_random_mask(const bitmask_context_t *ctx) {
+  if (ctx->mask_reuse > 1) {
+    if (reused_mask_count == 0) {
+      reused_mask = get_rand_uint64(&rng_state, &global_tid);
+      reused_mask_count = ctx->mask_reuse;
+    }
+    reused_mask_count--;
+    return reused_mask;
+  }
   return get_rand_uint64(&rng_state, &global_tid);
 }
 
+/* Fills masks with n 64-bits random masks */
+static void get_random_mask_vector(const bitmask_context_t *ctx,
+                                   uint64_t *masks, int n) {
+  if (ctx->mask_reuse > 1) {
+    for (int i = 0; i < n; i++) {
+      masks[i] = get_random_mask(ctx);
+    }
+  } else {
+    get_rand_uint64_vector(&rng_state, &global_tid, masks, n);
+  }
+}
+
 /* Returns a 32-bits random mask */
-static uint32_t get_random_binary32_mask() {
+static uint32_t get_random_binary32_mask(const bitmask_context_t *ctx) {
   binary64 mask;
-  mask.u64 = get_random_mask();
+  mask.u64 = get_random_mask(ctx);
   return mask.u32[0];
 }
 
 /* Returns a 64-bits random mask */
-static uint64_t get_random_binary64_mask() {
-  uint64_t mask = get_random_mask();
+static uint64_t get_random_binary64_mask(const bitmask_context_t *ctx) {
+  uint64_t mask = get_random_mask(ctx);
   return mask;
 }
 
@@ -458,6 +494,168 @@ static double _bitmask_binary64_ternary_op(double a, double b, double c,
   _BITMASK_TERNARY_OP(a, b, c, op, context);
 }
 
+/******************** BITMASK VECTOR FUNCTIONS ********************
+ * The following functions process all the lanes of a vector at once.
+ * Random masks for every lane are drawn in a single call to the vector
+ * RNG, and the OR/AND/XOR masks are applied with branchless bitwise
+ * operations over the lanes, which the compiler lowers to SIMD code.
+ ****************************************************************/
+
+/* lanes processed per chunk, matches the widest vector wrapper */
+#define BITMASK_VECTOR_MAX_SIZE 16
+
+/* Lanes that must not be noised get an all-ones keep mask, which cancels
+ * the bitmask operator for them */
+#define _INEXACT_VECTOR(CTX, X, N, B)                                          \
+  do {                                                                         \
+    bitmask_context_t *TMP_CTX = (bitmask_context_t *)(CTX);                   \
+    const typeof((B).u) sign_size = GET_SIGN_SIZE((B).type);                   \
+    const typeof((B).u) exp_size = GET_EXP_SIZE((B).type);                     \
+    const typeof((B).u) pman_size = GET_PMAN_SIZE((B).type);                   \
+    const typeof((B).u) mask_one = GET_MASK_ONE((B).type);                     \
+    const int binary_t = GET_BINARYN_T((B).type);                              \
+    typeof((B).u) u[BITMASK_VECTOR_MAX_SIZE];                                  \
+    typeof((B).u) keep[BITMASK_VECTOR_MAX_SIZE];                               \
+    typeof((B).u) bitmask[BITMASK_VECTOR_MAX_SIZE];                            \
+    _init_rng_state_struct(&rng_state, TMP_CTX->choose_seed,                   \
+                           (unsigned long long)(TMP_CTX->seed), false);        \
+    for (int i = 0; i < (N); i++) {                                            \
+      (B).type = (X)[i];                                                       \
+      u[i] = (B).u;                                                            \
+      keep[i] = (_MUST_NOT_BE_NOISED((X)[i], binary_t, TMP_CTX->mode))        \
+                    ? ~(typeof((B).u))0                                        \
+                    : 0;                                                       \
+      bitmask[i] = GET_BITMASK((B).type);                                      \
+      if (FPCLASSIFY((X)[i]) == FP_SUBNORMAL) {                                \
+        const typeof((B).u) leading_0 =                                        \
+            CLZ2((B).u, (B).ieee.mantissa) - (sign_size + exp_size);           \
+        if (pman_size < (leading_0 + binary_t)) {                              \
+          bitmask[i] = mask_one;                                               \
+        } else {                                                               \
+          bitmask[i] |= (mask_one << (pman_size - (leading_0 + binary_t)));    \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+    if (TMP_CTX->operator== bitmask_operator_rand) {                           \
+      uint64_t rand_mask[BITMASK_VECTOR_MAX_SIZE];                             \
+      get_random_mask_vector(TMP_CTX, rand_mask, (N));                         \
+      for (int i = 0; i < (N); i++) {                                          \
+        u[i] ^= ~keep[i] & ~bitmask[i] & (typeof((B).u))rand_mask[i];          \
+      }                                                                        \
+    } else if (TMP_CTX->operator== bitmask_operator_one) {                     \
+      for (int i = 0; i < (N); i++) {                                          \
+        u[i] |= ~keep[i] & ~bitmask[i];                                        \
+      }                                                                        \
+    } else if (TMP_CTX->operator== bitmask_operator_zero) {                    \
+      for (int i = 0; i < (N); i++) {                                          \
+        u[i] &= keep[i] | bitmask[i];                                          \
+      }                                                                        \
+    } else {                                                                   \
+      __builtin_unreachable();                                                 \
+    }                                                                          \
+    for (int i = 0; i < (N); i++) {                                            \
+      (B).u = u[i];                                                            \
+      (X)[i] = (B).type;                                                       \
+    }                                                                          \
+  } while (0);
+
+static void _inexact_binary32_vector(void *context, float *x, int n) {
+  bitmask_context_t *ctx = (bitmask_context_t *)context;
+  if (ctx->mode == bitmask_mode_ieee) {
+    return;
+  }
+  binary32 b32;
+  _INEXACT_VECTOR(context, x, n, b32);
+}
+
+static void _inexact_binary64_vector(void *context, double *x, int n) {
+  bitmask_context_t *ctx = (bitmask_context_t *)context;
+  if (ctx->mode == bitmask_mode_ieee) {
+    return;
+  }
+  binary64 b64;
+  _INEXACT_VECTOR(context, x, n, b64);
+}
+
+#define _INEXACT_BINARYN_VECTOR(CTX, X, N)                                     \
+  _Generic(X,                                                                  \
+      float *: _inexact_binary32_vector,                                       \
+      double *: _inexact_binary64_vector)(CTX, X, N)
+
+/* The operator switch is hoisted out of the lane loop */
+#define PERFORM_VECTOR_BIN_OP(OP, RES, A, B, N)                                \
+  switch (OP) {                                                                \
+  case bitmask_add:                                                            \
+    for (int i = 0; i < (N); i++)                                              \
+      (RES)[i] = (A)[i] + (B)[i];                                              \
+    break;                                                                     \
+  case bitmask_mul:                                                            \
+    for (int i = 0; i < (N); i++)                                              \
+      (RES)[i] = (A)[i] * (B)[i];                                              \
+    break;                                                                     \
+  case bitmask_sub:                                                            \
+    for (int i = 0; i < (N); i++)                                              \
+      (RES)[i] = (A)[i] - (B)[i];                                              \
+    break;                                                                     \
+  case bitmask_div:                                                            \
+    for (int i = 0; i < (N); i++)                                              \
+      (RES)[i] = (A)[i] / (B)[i];                                              \
+    break;                                                                     \
+  default:                                                                     \
+    logger_error("invalid operator %c", OP);                                   \
+  };
+
+#define _BITMASK_VECTOR_BINARY_OP(SIZE, A, B, RES, OP, CTX)                    \
+  {                                                                            \
+    bitmask_context_t *TMP_CTX = (bitmask_context_t *)(CTX);                   \
+    typeof(*(RES)) X[BITMASK_VECTOR_MAX_SIZE];                                 \
+    typeof(*(RES)) Y[BITMASK_VECTOR_MAX_SIZE];                                 \
+    typeof(*(RES)) Z[BITMASK_VECTOR_MAX_SIZE];                                 \
+    for (int k = 0; k < (SIZE); k += BITMASK_VECTOR_MAX_SIZE) {                \
+      const int n = ((SIZE)-k < BITMASK_VECTOR_MAX_SIZE)                       \
+                        ? (SIZE)-k                                             \
+                        : BITMASK_VECTOR_MAX_SIZE;                             \
+      for (int i = 0; i < n; i++) {                                            \
+        X[i] = (A)[k + i];                                                     \
+        Y[i] = (B)[k + i];                                                     \
+        if (TMP_CTX->daz) {                                                    \
+          X[i] = DAZ(X[i]);                                                    \
+          Y[i] = DAZ(Y[i]);                                                    \
+        }                                                                      \
+      }                                                                        \
+      if (TMP_CTX->mode == bitmask_mode_ib ||                                  \
+          TMP_CTX->mode == bitmask_mode_full) {                                \
+        _INEXACT_BINARYN_VECTOR(CTX, X, n);                                    \
+        _INEXACT_BINARYN_VECTOR(CTX, Y, n);                                    \
+      }                                                                        \
+      PERFORM_VECTOR_BIN_OP(OP, Z, X, Y, n);                                   \
+      if (TMP_CTX->mode == bitmask_mode_ob ||                                  \
+          TMP_CTX->mode == bitmask_mode_full) {                                \
+        _INEXACT_BINARYN_VECTOR(CTX, Z, n);                                    \
+      }                                                                        \
+      for (int i = 0; i < n; i++) {                                            \
+        if (TMP_CTX->ftz) {                                                    \
+          Z[i] = FTZ(Z[i]);                                                    \
+        }                                                                      \
+        (RES)[k + i] = Z[i];                                                   \
+      }                                                                        \
+    }                                                                          \
+  }
+
+static void _bitmask_binary32_vector_op(int size, const float *a,
+                                        const float *b, float *res,
+                                        const bitmask_operations op,
+                                        void *context) {
+  _BITMASK_VECTOR_BINARY_OP(size, a, b, res, op, context);
+}
+
+static void _bitmask_binary64_vector_op(int size, const double *a,
+                                        const double *b, double *res,
+                                        const bitmask_operations op,
+                                        void *context) {
+  _BITMASK_VECTOR_BINARY_OP(size, a, b, res, op, context);
+}
+
 /******************** BITMASK COMPARE FUNCTIONS ********************
  * Compare operations do not require BITMASK
  ****************************************************************/
@@ -518,6 +716,54 @@ void INTERFLOP_BITMASK_API(fma_double)(double a, double b, double c,
   *res = _bitmask_binary64_ternary_op(a, b, c, bitmask_fma, context);
 }
 
+void INTERFLOP_BITMASK_API(add_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, res, bitmask_add, context);
+}
+
+void INTERFLOP_BITMASK_API(sub_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, res, bitmask_sub, context);
+}
+
+void INTERFLOP_BITMASK_API(mul_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, res, bitmask_mul, context);
+}
+
+void INTERFLOP_BITMASK_API(div_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context) {
+  _bitmask_binary32_vector_op(size, a, b, res, bitmask_div, context);
+}
+
+void INTERFLOP_BITMASK_API(add_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, res, bitmask_add, context);
+}
+
+void INTERFLOP_BITMASK_API(sub_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, res, bitmask_sub, context);
+}
+
+void INTERFLOP_BITMASK_API(mul_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, res, bitmask_mul, context);
+}
+
+void INTERFLOP_BITMASK_API(div_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context) {
+  _bitmask_binary64_vector_op(size, a, b, res, bitmask_div, context);
+}
+
 void INTERFLOP_BITMASK_API(cast_double_to_float)(double a, float *res,
                                                  void *context) {
   *res = (float)_bitmask_binary64_unary_op(a, bitmask_cast, context);
@@ -545,6 +791,8 @@ static const struct argp_option options[] = {
      "denormals-are-zero: sets denormals inputs to zero", 0},
     {key_ftz_str, KEY_FTZ, 0, 0, "flush-to-zero: sets denormal output to zero",
      0},
+    {key_mask_reuse_str, KEY_MASK_REUSE, "N", 0,
+     "reuse each random mask for N consecutive draws (N > 0)", 0},
     {0}};
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
@@ -578,6 +826,19 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
       _set_bitmask_precision_binary64(val, ctx);
     }
     break;
+  case KEY_MASK_REUSE:
+    /* number of draws served by one random mask */
+    error = 0;
+    val = (int)interflop_strtol(arg, &endptr, &error);
+    if (error != 0 || val <= 0) {
+      logger_error("--%s invalid "
+                   "value provided, must be a "
+                   "positive integer.",
+                   key_mask_reuse_str);
+    } else {
+      _set_bitmask_mask_reuse(val, ctx);
+    }
+    break;
   case KEY_MODE:
     /* mode */
     if (interflop_strcasecmp(BITMASK_MODE_STR[bitmask_mode_ieee], arg) == 0) {
@@ -673,6 +934,7 @@ static void _bitmask_init_context(bitmask_context_t *ctx) {
   ctx->seed = BITMASK_SEED_DEFAULT;
   ctx->daz = BITMASK_DAZ_DEFAULT;
   ctx->ftz = BITMASK_FTZ_DEFAULT;
+  ctx->mask_reuse = BITMASK_MASK_REUSE_DEFAULT;
 }
 
 void INTERFLOP_BITMASK_API(pre_init)(interflop_panic_t panic, File *stream,
@@ -710,6 +972,10 @@ void INTERFLOP_BITMASK_API(configure)(void *configure, void *context) {
   _set_bitmask_operator(conf->operator, ctx);
   _set_bitmask_daz(conf->daz, ctx);
   _set_bitmask_ftz(conf->ftz, ctx);
+  /* Configurations written before mask_reuse existed leave it to zero */
+  _set_bitmask_mask_reuse(
+      conf->mask_reuse == 0 ? BITMASK_MASK_REUSE_DEFAULT : conf->mask_reuse,
+      ctx);
 }
 
 static void print_information_header(void *context) {
@@ -737,6 +1003,7 @@ static void print_information_header(void *context) {
               BITMASK_OPERATOR_STR[ctx->operator]);
   logger_info("%s = %s\n", key_daz_str, ctx->daz ? "true" : "false");
   logger_info("%s = %s\n", key_ftz_str, ctx->ftz ? "true" : "false");
+  logger_info("%s = %d\n", key_mask_reuse_str, ctx->mask_reuse);
   logger_info("%s = %lu%s\n", key_seed_str, ctx->seed,
               ctx->choose_seed ? " (fixed)" : "");
 }
@@ -763,7 +1030,15 @@ INTERFLOP_BITMASK_API(init)(void *context) {
       .interflop_enter_function = NULL,
       .interflop_exit_function = NULL,
       .interflop_user_call = NULL,
-      .interflop_finalize = NULL};
+      .interflop_finalize = NULL,
+      .interflop_add_float_vector = INTERFLOP_BITMASK_API(add_float_vector),
+      .interflop_sub_float_vector = INTERFLOP_BITMASK_API(sub_float_vector),
+      .interflop_mul_float_vector = INTERFLOP_BITMASK_API(mul_float_vector),
+      .interflop_div_float_vector = INTERFLOP_BITMASK_API(div_float_vector),
+      .interflop_add_double_vector = INTERFLOP_BITMASK_API(add_double_vector),
+      .interflop_sub_double_vector = INTERFLOP_BITMASK_API(sub_double_vector),
+      .interflop_mul_double_vector = INTERFLOP_BITMASK_API(mul_double_vector),
+      .interflop_div_double_vector = INTERFLOP_BITMASK_API(div_double_vector)};
 
   /* The seed for the RNG is initialized upon the first request for a random
   number */
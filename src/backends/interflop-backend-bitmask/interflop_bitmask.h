@@ -30,6 +30,7 @@
 #define BITMASK_SEED_DEFAULT 0ULL
 #define BITMASK_DAZ_DEFAULT IFalse
 #define BITMASK_FTZ_DEFAULT IFalse
+#define BITMASK_MASK_REUSE_DEFAULT 1
 
 /* define the available BITMASK modes of operation */
 typedef enum {
@@ -58,6 +59,7 @@ typedef struct {
   IBool choose_seed;
   IBool daz;
   IBool ftz;
+  int mask_reuse;
 } bitmask_context_t;
 
 typedef bitmask_context_t bitmask_conf_t;
@@ -88,6 +90,30 @@ void INTERFLOP_BITMASK_API(div_double)(double a, double b, double *res,
                                        void *context);
 void INTERFLOP_BITMASK_API(fma_double)(double a, double b, double c,
                                        double *res, void *context);
+void INTERFLOP_BITMASK_API(add_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context);
+void INTERFLOP_BITMASK_API(sub_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context);
+void INTERFLOP_BITMASK_API(mul_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context);
+void INTERFLOP_BITMASK_API(div_float_vector)(int size, const float *a,
+                                             const float *b, float *res,
+                                             void *context);
+void INTERFLOP_BITMASK_API(add_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context);
+void INTERFLOP_BITMASK_API(sub_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context);
+void INTERFLOP_BITMASK_API(mul_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context);
+void INTERFLOP_BITMASK_API(div_double_vector)(int size, const double *a,
+                                              const double *b, double *res,
+                                              void *context);
 void INTERFLOP_BITMASK_API(cast_double_to_float)(double a, float *res,
                                                  void *context);
 void INTERFLOP_BITMASK_API(pre_init)(interflop_panic_t panic, File *stream,
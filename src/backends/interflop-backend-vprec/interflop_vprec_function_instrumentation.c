@@ -168,36 +168,35 @@ void _vfi_print_information_header(void *context) {
 
 // Write the hashmap in the given file
 void _vfi_write_hasmap(FILE *fout, vprec_context_t *ctx) {
-  for (size_t ii = 0; ii < ctx->vfi->map->capacity; ii++) {
-    if (get_value_at(ctx->vfi->map->items, ii) != 0 &&
-        get_value_at(ctx->vfi->map->items, ii) != 0) {
-      _vfi_t *function = (_vfi_t *)get_value_at(ctx->vfi->map->items, ii);
-
-      interflop_fprintf(
-          fout, "%s\t%hhd\t%hhd\t%hhd\t%hhd\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n",
-          function->id, function->isLibraryFunction,
-          function->isIntrinsicFunction, function->useFloat,
-          function->useDouble, function->OpsPrec64, function->OpsRange64,
-          function->OpsPrec32, function->OpsRange32, function->nb_input_args,
-          function->nb_output_args, function->n_calls);
-      for (int i = 0; i < function->nb_input_args; i++) {
-        interflop_fprintf(fout, "input:\t%s\t%hd\t%d\t%d\t%d\t%d\n",
-                          function->input_args[i].arg_id,
-                          function->input_args[i].data_type,
-                          function->input_args[i].mantissa_length,
-                          function->input_args[i].exponent_length,
-                          function->input_args[i].min_range,
-                          function->input_args[i].max_range);
-      }
-      for (int i = 0; i < function->nb_output_args; i++) {
-        interflop_fprintf(fout, "output:\t%s\t%hd\t%d\t%d\t%d\t%d\n",
-                          function->output_args[i].arg_id,
-                          function->output_args[i].data_type,
-                          function->output_args[i].mantissa_length,
-                          function->output_args[i].exponent_length,
-                          function->output_args[i].min_range,
-                          function->output_args[i].max_range);
-      }
+  size_t cursor = 0;
+  void *value;
+  while (vfc_swisstable_next(ctx->vfi->map, &cursor, NULL, &value)) {
+    _vfi_t *function = (_vfi_t *)value;
+
+    interflop_fprintf(
+        fout, "%s\t%hhd\t%hhd\t%hhd\t%hhd\t%d\t%d\t%d\t%d\t%d\t%d\t%d\n",
+        function->id, function->isLibraryFunction,
+        function->isIntrinsicFunction, function->useFloat,
+        function->useDouble, function->OpsPrec64, function->OpsRange64,
+        function->OpsPrec32, function->OpsRange32, function->nb_input_args,
+        function->nb_output_args, function->n_calls);
+    for (int i = 0; i < function->nb_input_args; i++) {
+      interflop_fprintf(fout, "input:\t%s\t%hd\t%d\t%d\t%d\t%d\n",
+                        function->input_args[i].arg_id,
+                        function->input_args[i].data_type,
+                        function->input_args[i].mantissa_length,
+                        function->input_args[i].exponent_length,
+                        function->input_args[i].min_range,
+                        function->input_args[i].max_range);
+    }
+    for (int i = 0; i < function->nb_output_args; i++) {
+      interflop_fprintf(fout, "output:\t%s\t%hd\t%d\t%d\t%d\t%d\n",
+                        function->output_args[i].arg_id,
+                        function->output_args[i].data_type,
+                        function->output_args[i].mantissa_length,
+                        function->output_args[i].exponent_length,
+                        function->output_args[i].min_range,
+                        function->output_args[i].max_range);
     }
   }
 }
@@ -296,12 +295,14 @@ void _vfi_read_hasmap(FILE *fin, vprec_context_t *ctx) {
 
   while (_vfi_scan_header(fin, &function) == 12) {
     // allocate space for input arguments
-    function.input_args = (_vfi_argument_data_t *)interflop_calloc(
-        function.nb_input_args, sizeof(_vfi_argument_data_t));
+    function.input_args = (_vfi_argument_data_t *)vfc_arena_alloc(
+        ctx->vfi->arena,
+        function.nb_input_args * sizeof(_vfi_argument_data_t));
 
     // allocate space for output arguments
-    function.output_args = (_vfi_argument_data_t *)interflop_calloc(
-        function.nb_output_args, sizeof(_vfi_argument_data_t));
+    function.output_args = (_vfi_argument_data_t *)vfc_arena_alloc(
+        ctx->vfi->arena,
+        function.nb_output_args * sizeof(_vfi_argument_data_t));
 
     const int elt_to_read = 7;
     // get input arguments precision
@@ -319,10 +320,12 @@ void _vfi_read_hasmap(FILE *fin, vprec_context_t *ctx) {
     }
 
     // insert in the hashmap
-    _vfi_t *address = (_vfi_t *)interflop_malloc(sizeof(_vfi_t));
+    _vfi_t *address =
+        (_vfi_t *)vfc_arena_alloc(ctx->vfi->arena, sizeof(_vfi_t));
     (*address) = function;
-    vfc_hashmap_insert(ctx->vfi->map, vfc_hashmap_str_function(function.id),
-                       address);
+    vfc_swisstable_insert(ctx->vfi->map,
+                          vfc_strintern_id(ctx->vfi->names, function.id),
+                          address);
   }
 }
 
@@ -346,7 +349,10 @@ void _vfi_alloc_context(void *context) {
 /* initialize the context */
 void _vfi_init_context(void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
+  ctx->vfi->arena = NULL;
+  ctx->vfi->names = NULL;
   ctx->vfi->map = NULL;
+  ctx->vfi->uid_map = NULL;
   ctx->vfi->vprec_input_file = NULL;
   ctx->vfi->vprec_output_file = NULL;
   ctx->vfi->vprec_log_file = NULL;
@@ -363,7 +369,10 @@ void _vfi_init(void *context) {
   vprec_context_t *ctx = (vprec_context_t *)context;
   /* Initialize the vprec_function_map */
 
-  ctx->vfi->map = vfc_hashmap_create();
+  ctx->vfi->arena = vfc_arena_create();
+  ctx->vfi->names = vfc_strintern_create();
+  ctx->vfi->map = vfc_swisstable_create();
+  ctx->vfi->uid_map = vfc_swisstable_create();
   /* read the hashmap */
   if (ctx->vfi->vprec_input_file != NULL) {
     int error = 0;
@@ -410,11 +419,13 @@ void _vfi_finalize(void *context) {
     interflop_fclose(_vprec_log_file);
   }
 
-  /* free vprec_function_map */
-  vfc_hashmap_free(ctx->vfi->map);
-
   /* destroy vprec_function_map */
-  vfc_hashmap_destroy(ctx->vfi->map);
+  vfc_swisstable_destroy(ctx->vfi->uid_map);
+  vfc_swisstable_destroy(ctx->vfi->map);
+  vfc_strintern_destroy(ctx->vfi->names);
+
+  /* free the function data */
+  vfc_arena_destroy(ctx->vfi->arena);
 
   FREE_STRING(tokens_header, elt_to_read_header);
   FREE_STRING(tokens_inputs, elt_to_read_inputs);
@@ -543,6 +554,30 @@ void _vfi_print_log_exit(void *raw_value, _vfi_t *function_inst, char *arg_id,
                         ctx);
 }
 
+// Get the data of a function, NULL if the function is not in the hashmap.
+// The name is only hashed the first time a frontend uid is seen.
+static _vfi_t *_vfi_get(vprec_context_t *ctx,
+                        const interflop_function_info_t *function_info) {
+  _vfi_t *function_inst = NULL;
+
+  if (function_info->uid != 0) {
+    function_inst = vfc_swisstable_get(ctx->vfi->uid_map, function_info->uid);
+    if (function_inst != NULL)
+      return function_inst;
+  }
+
+  ISize_t id = vfc_strintern_lookup(ctx->vfi->names, function_info->id);
+  if (id == VFC_STRINTERN_NONE)
+    return NULL;
+
+  function_inst = vfc_swisstable_get(ctx->vfi->map, id);
+  if (function_inst != NULL && function_info->uid != 0)
+    vfc_swisstable_insert(ctx->vfi->uid_map, function_info->uid,
+                          function_inst);
+
+  return function_inst;
+}
+
 // vprec function instrumentation
 // Set precision for internal operations and round input arguments for a given
 // function call
@@ -555,12 +590,11 @@ void _vfi_enter_function(interflop_function_stack_t *stack, void *context,
   if (function_info == NULL)
     logger_error("Call stack error\n");
 
-  _vfi_t *function_inst = vfc_hashmap_get(
-      ctx->vfi->map, vfc_hashmap_str_function(function_info->id));
+  _vfi_t *function_inst = _vfi_get(ctx, function_info);
 
   // if the function is not in the hashtable
   if (function_inst == NULL) {
-    function_inst = interflop_malloc(sizeof(_vfi_t));
+    function_inst = vfc_arena_alloc(ctx->vfi->arena, sizeof(_vfi_t));
 
     // initialize the structure
     interflop_strcpy(function_inst->id, function_info->id);
@@ -578,10 +612,15 @@ void _vfi_enter_function(interflop_function_stack_t *stack, void *context,
     function_inst->output_args = NULL;
     function_inst->n_calls = 0;
 
-    // insert the function in the hashmap
-    vfc_hashmap_insert(ctx->vfi->map,
-                       vfc_hashmap_str_function(function_info->id),
-                       function_inst);
+    // insert the function in the hashmap, another thread may have inserted
+    // it in the meantime, in which case function_inst stays unused in the
+    // arena
+    function_inst = vfc_swisstable_insert_if_absent(
+        ctx->vfi->map, vfc_strintern_id(ctx->vfi->names, function_info->id),
+        function_inst);
+    if (function_info->uid != 0)
+      vfc_swisstable_insert(ctx->vfi->uid_map, function_info->uid,
+                            function_inst);
   }
 
   // increment the number of calls
@@ -609,8 +648,8 @@ void _vfi_enter_function(interflop_function_stack_t *stack, void *context,
 
   // allocate memory for arguments
   if (new_flag) {
-    function_inst->input_args =
-        interflop_calloc(nb_args, sizeof(_vfi_argument_data_t));
+    function_inst->input_args = vfc_arena_alloc(
+        ctx->vfi->arena, nb_args * sizeof(_vfi_argument_data_t));
     function_inst->nb_input_args = nb_args;
   }
 
@@ -714,8 +753,7 @@ void _vfi_exit_function(interflop_function_stack_t *stack, void *context,
     logger_error("Call stack error \n");
   }
 
-  _vfi_t *function_inst = vfc_hashmap_get(
-      ctx->vfi->map, vfc_hashmap_str_function(function_info->id));
+  _vfi_t *function_inst = _vfi_get(ctx, function_info);
 
   // set internal operations precision with parent function values
   if (stack->array[stack->top + 1] != NULL) {
@@ -725,8 +763,7 @@ void _vfi_exit_function(interflop_function_stack_t *stack, void *context,
         ctx->vfi->vprec_inst_mode != vprecinst_arg &&
         ctx->vfi->vprec_inst_mode != vprecinst_none) {
 
-      _vfi_t *function_parent = vfc_hashmap_get(
-          ctx->vfi->map, vfc_hashmap_str_function(parent_info->id));
+      _vfi_t *function_parent = _vfi_get(ctx, parent_info);
 
       if (function_parent != NULL) {
         _set_vprec_precision_binary64(function_parent->OpsPrec64, ctx);
@@ -747,8 +784,8 @@ void _vfi_exit_function(interflop_function_stack_t *stack, void *context,
 
   // allocate memory for arguments
   if (new_flag) {
-    function_inst->output_args =
-        interflop_calloc(nb_args, sizeof(_vfi_argument_data_t));
+    function_inst->output_args = vfc_arena_alloc(
+        ctx->vfi->arena, nb_args * sizeof(_vfi_argument_data_t));
     function_inst->nb_output_args = nb_args;
   }
 
@@ -21,7 +21,10 @@
 #ifndef __INTERFLOP_VPREC_FUNCTION_INSTRUMENTATION_H__
 #define __INTERFLOP_VPREC_FUNCTION_INSTRUMENTATION_H__
 
+#include "interflop/hashmap/vfc_arena.h"
 #include "interflop/hashmap/vfc_hashmap.h"
+#include "interflop/hashmap/vfc_strintern.h"
+#include "interflop/hashmap/vfc_swisstable.h"
 #include "interflop/interflop.h"
 #include "interflop/interflop_stdlib.h"
 
@@ -90,7 +93,14 @@ typedef struct _vprec_function_instrumentation {
 
 typedef struct {
   /* instrumentation variables */
-  vfc_hashmap_t map;
+  /* storage of the function data, released at finalize */
+  vfc_arena_t arena;
+  /* function names -> dense IDs */
+  vfc_strintern_t names;
+  /* name IDs -> function data */
+  vfc_swisstable_t map;
+  /* frontend function uids -> function data */
+  vfc_swisstable_t uid_map;
   const char *vprec_input_file;
   const char *vprec_output_file;
   const char *vprec_log_file;
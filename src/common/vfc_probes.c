@@ -24,11 +24,16 @@
  * Verificarlo test report.
  */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
+#include "interflop/hashmap/vfc_arena.h"
 #include "interflop/hashmap/vfc_hashmap.h"
+#include "interflop/hashmap/vfc_strintern.h"
+#include "interflop/hashmap/vfc_swisstable.h"
 
 #ifndef VAR_NAME
 #define VAR_NAME(var) #var // Simply returns the name of var into a string
@@ -47,9 +52,17 @@ struct vfc_probe_node {
 
 typedef struct vfc_probe_node vfc_probe_node;
 
-// The probes structure. It simply acts as a wrapper for a Verificarlo hashmap.
+// The probes structure. It simply acts as a wrapper for a Verificarlo
+// concurrent hash table, keyed by the interned ID of the probe keys. The
+// probes are stored in an arena released by vfc_free_probes. In streaming
+// mode, the probes are written to the output file during the run instead and
+// the table only records the keys already seen.
 struct vfc_probes {
-  vfc_hashmap_t map;
+  vfc_swisstable_t map;
+  vfc_strintern_t keys;
+  vfc_arena_t arena;
+  struct vfc_probes_stream *stream;
+  int check_duplicates;
 };
 
 typedef struct vfc_probes vfc_probes;
@@ -74,11 +87,40 @@ int vfc_probe(vfc_probes *probes, char *testName, char *varName, double val);
 int vfc_probe_check(vfc_probes *probes, char *testName, char *varName,
                     double val, double accuracyThreshold);
 
-// Return the number of probes stored in the hashmap
+// Register a probe name and return its ID, which can be used with the *_id
+// functions to skip the key generation and lookup on every call
+size_t vfc_probe_register(vfc_probes *probes, char *testName, char *varName);
+
+// Probe kernel function working on a registered probe ID
+int vfc_probe_id_kernel(vfc_probes *probes, size_t id, double val,
+                        double accuracyThreshold, char *mode);
+
+// Similar to vfc_probe, vfc_probe_check and vfc_probe_check_relative, with a
+// probe ID returned by vfc_probe_register
+int vfc_probe_id(vfc_probes *probes, size_t id, double val);
+
+int vfc_probe_check_id(vfc_probes *probes, size_t id, double val,
+                       double accuracyThreshold);
+
+int vfc_probe_check_relative_id(vfc_probes *probes, size_t id, double val,
+                                double accuracyThreshold);
+
+// Return the number of probes stored in the hashmap, or written so far in
+// streaming mode
 unsigned int vfc_num_probes(vfc_probes *probes);
 
-// Dump probes in a .csv file (the double values are converted to hex), then
-// free it.
+// Dump the probes in the file named by VFC_PROBES_OUTPUT, then free them. The
+// VFC_PROBES_FORMAT environment variable selects the format of the file:
+//  - "csv" (default): a "test,variable,value,accuracy_threshold,check_mode"
+//    header, then one line per probe, the doubles being converted to hex
+//  - "binary": a header holding the number of probes and keys and the offset
+//    of each column, then the value and accuracy threshold columns (doubles),
+//    the key column (uint32 index in the dictionary), the check mode column
+//    (uint8: 0 none, 1 absolute, 2 relative) and the dictionary of the
+//    "test,variable" keys. Columns are aligned on 8 bytes and use the byte
+//    order of the host, so they can be mapped in place (see vfc_probes.c)
+// In streaming mode (VFC_PROBES_STREAM), the probes are already written in CSV:
+// the remaining ones are flushed and the file closed.
 int vfc_dump_probes(vfc_probes *probes);
 
 // Fortran wrapper
@@ -88,33 +130,215 @@ void vfc_init_probes_f(vfc_probes *probes);
 
 /******************************************************************************/
 
-// Initialize an empty vfc_probes instance
+// Default size of the per-thread buffers of the streaming mode
+#define VFC_PROBES_STREAM_CHUNK 65536
+
+// Per-thread buffer of formatted CSV records. Buffers are only added to the
+// stream, and released when the stream is closed.
+struct vfc_probes_buffer {
+  struct vfc_probes_buffer *next;
+  // Thread owning the buffer
+  const void *owner;
+  size_t length;
+  char data[];
+};
+
+struct vfc_probes_stream {
+  FILE *fp;
+  size_t chunk_size;
+  struct vfc_probes_buffer *buffers;
+  size_t count;
+  // Unique among the streams of the process, a stream allocated at the
+  // address of a closed one does not match the buffer caches of the threads
+  uint64_t id;
+};
+
+// Last stream ID given
+static uint64_t vfc_probes_stream_counter = 0;
+
+// Address unique to each thread, used to identify the owner of a buffer
+static __thread char vfc_probes_thread_token;
+
+// Last buffer used by the thread, and the ID of its stream (0 for none)
+static __thread uint64_t vfc_probes_cached_stream = 0;
+static __thread struct vfc_probes_buffer *vfc_probes_cached_buffer = NULL;
+
+// Return the value of a boolean environment variable, any value other than
+// "False" enables it
+static int vfc_probes_env_flag(const char *name, int default_value) {
+  const char *env = getenv(name);
+  if (env == NULL) {
+    return default_value;
+  }
+  return strcasecmp(env, "False") != 0;
+}
+
+// Open the output file for streaming, NULL if the streaming mode is disabled
+static struct vfc_probes_stream *vfc_probes_open_stream(void) {
+  if (!vfc_probes_env_flag("VFC_PROBES_STREAM", 0)) {
+    return NULL;
+  }
+
+  char *exportPath = getenv("VFC_PROBES_OUTPUT");
+  if (!exportPath) {
+    printf("Warning [verificarlo]: VFC_PROBES_OUTPUT is not set, probes will \
+            not be streamed\n");
+    return NULL;
+  }
+
+  size_t chunk_size = VFC_PROBES_STREAM_CHUNK;
+  char *chunkSize = getenv("VFC_PROBES_STREAM_CHUNK");
+  if (chunkSize != NULL) {
+    char *end;
+    long size = strtol(chunkSize, &end, 10);
+    if (*end != '\0' || size < 256) {
+      fprintf(stderr,
+              "Error [verificarlo]: VFC_PROBES_STREAM_CHUNK must be an \
+              integer of at least 256 (\"%s\")\n",
+              chunkSize);
+      exit(1);
+    }
+    chunk_size = size;
+  }
+
+  FILE *fp = fopen(exportPath, "w");
+  if (fp == NULL) {
+    fprintf(stderr,
+            "Error [verificarlo]: impossible to open the CSV file to save your \
+            probes (\"%s\")\n",
+            exportPath);
+    exit(1);
+  }
+
+  // First line gives the column names
+  fprintf(fp, "test,variable,value,accuracy_threshold,check_mode\n");
+  fflush(fp);
+
+  struct vfc_probes_stream *stream =
+      (struct vfc_probes_stream *)calloc(1, sizeof(struct vfc_probes_stream));
+  stream->fp = fp;
+  stream->chunk_size = chunk_size;
+  stream->id =
+      __atomic_add_fetch(&vfc_probes_stream_counter, 1, __ATOMIC_RELAXED);
+
+  return stream;
+}
+
+// Write the content of a buffer in the output file. A buffer is written with
+// the file locked so that the chunks of different threads do not interleave.
+static void vfc_probes_flush_buffer(struct vfc_probes_stream *stream,
+                                    struct vfc_probes_buffer *buffer) {
+  if (buffer->length > 0) {
+    flockfile(stream->fp);
+    fwrite(buffer->data, 1, buffer->length, stream->fp);
+    fflush(stream->fp);
+    funlockfile(stream->fp);
+    buffer->length = 0;
+  }
+}
+
+// Return the buffer of the calling thread for the stream
+static struct vfc_probes_buffer *
+vfc_probes_thread_buffer(struct vfc_probes_stream *stream) {
+  if (vfc_probes_cached_stream == stream->id) {
+    return vfc_probes_cached_buffer;
+  }
+
+  struct vfc_probes_buffer *buffer =
+      __atomic_load_n(&stream->buffers, __ATOMIC_ACQUIRE);
+  while (buffer != NULL && buffer->owner != &vfc_probes_thread_token) {
+    buffer = buffer->next;
+  }
+
+  if (buffer == NULL) {
+    buffer = (struct vfc_probes_buffer *)malloc(
+        sizeof(struct vfc_probes_buffer) + stream->chunk_size);
+    buffer->owner = &vfc_probes_thread_token;
+    buffer->length = 0;
+    buffer->next = __atomic_load_n(&stream->buffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&stream->buffers, &buffer->next,
+                                        buffer, 0, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED))
+      ;
+  }
+
+  vfc_probes_cached_stream = stream->id;
+  vfc_probes_cached_buffer = buffer;
+  return buffer;
+}
+
+// Append a record to the buffer of the calling thread, and write the buffer
+// when it is full
+static void vfc_probes_stream_record(struct vfc_probes_stream *stream,
+                                     const char *key, double val,
+                                     double accuracyThreshold,
+                                     const char *mode) {
+  struct vfc_probes_buffer *buffer = vfc_probes_thread_buffer(stream);
+  __atomic_add_fetch(&stream->count, 1, __ATOMIC_RELAXED);
+
+  for (int attempt = 0; attempt < 2; attempt++) {
+    size_t space = stream->chunk_size - buffer->length;
+    int n = snprintf(buffer->data + buffer->length, space, "%s,%a,%a,%s\n",
+                     key, val, accuracyThreshold, mode);
+    if (n >= 0 && (size_t)n < space) {
+      buffer->length += n;
+      return;
+    }
+    vfc_probes_flush_buffer(stream, buffer);
+  }
+
+  // The record is larger than a buffer
+  flockfile(stream->fp);
+  fprintf(stream->fp, "%s,%a,%a,%s\n", key, val, accuracyThreshold, mode);
+  fflush(stream->fp);
+  funlockfile(stream->fp);
+}
+
+// Write the remaining records and close the output file. The threads that
+// recorded probes must be done.
+static void vfc_probes_close_stream(struct vfc_probes_stream *stream) {
+  struct vfc_probes_buffer *buffer = stream->buffers;
+  while (buffer != NULL) {
+    struct vfc_probes_buffer *next = buffer->next;
+    vfc_probes_flush_buffer(stream, buffer);
+    free(buffer);
+    buffer = next;
+  }
+
+  // The caches of the other threads are invalidated by the ID of the stream
+  if (vfc_probes_cached_stream == stream->id) {
+    vfc_probes_cached_stream = 0;
+    vfc_probes_cached_buffer = NULL;
+  }
+
+  fclose(stream->fp);
+  free(stream);
+}
+
+// Initialize an empty vfc_probes instance. The VFC_PROBES_STREAM and
+// VFC_PROBES_CHECK_DUPLICATES environment variables select the mode.
 vfc_probes vfc_init_probes() {
   vfc_probes probes;
-  probes.map = vfc_hashmap_create();
+  probes.map = vfc_swisstable_create();
+  probes.keys = vfc_strintern_create();
+  probes.arena = vfc_arena_create();
+  probes.stream = vfc_probes_open_stream();
+  probes.check_duplicates =
+      vfc_probes_env_flag("VFC_PROBES_CHECK_DUPLICATES", 1);
 
   return probes;
 }
 
 // Free all probes
 void vfc_free_probes(vfc_probes *probes) {
-
-  // Before freeing the map, iterate manually over all items to free the keys
-  vfc_probe_node *probe = NULL;
-  for (size_t i = 0; i < probes->map->capacity; i++) {
-    probe = (vfc_probe_node *)get_value_at(probes->map->items, i);
-
-    // Comparing with 1 is also necessary since it will be the value of deleted
-    // nodes
-    if (probe != NULL && probe != (vfc_probe_node *)1) {
-      if (probe->key != NULL) {
-        free(probe->key);
-        free(probe->mode);
-      }
-    }
+  if (probes->stream != NULL) {
+    vfc_probes_close_stream(probes->stream);
+    probes->stream = NULL;
   }
 
-  vfc_hashmap_free(probes->map);
+  vfc_swisstable_destroy(probes->map);
+  vfc_strintern_destroy(probes->keys);
+  vfc_arena_destroy(probes->arena);
 }
 
 // Helper function to generate the key from test and variable name
@@ -151,6 +375,13 @@ int vfc_probe_kernel(vfc_probes *probes, char *testName, char *varName,
     return 1;
   }
 
+  return vfc_probe_id_kernel(probes,
+                             vfc_probe_register(probes, testName, varName),
+                             val, accuracyThreshold, mode);
+}
+
+// Register a probe name and return its ID
+size_t vfc_probe_register(vfc_probes *probes, char *testName, char *varName) {
   // Make sure testName and varName don't contain any ',', which would
   // interfere with the key/CSV encoding
   validate_probe_key(testName);
@@ -158,30 +389,57 @@ int vfc_probe_kernel(vfc_probes *probes, char *testName, char *varName,
 
   // Get the key, which is : testName + "," + varName
   char *key = gen_probe_key(testName, varName);
+  size_t id = vfc_strintern_id(probes->keys, key);
+  free(key);
 
-  // Look for a duplicate key
-  vfc_probe_node *oldProbe = (vfc_probe_node *)vfc_hashmap_get(
-      probes->map, vfc_hashmap_str_function(key));
+  return id;
+}
 
-  if (oldProbe != NULL) {
-    if (strcmp(key, oldProbe->key) == 0) {
-      fprintf(stderr,
-              "Error [verificarlo]: you have a duplicate error with one of \
-              your probes (\"%s\"). Please make sure to use different names.\n",
-              key);
-      exit(1);
-    }
+// Probe kernel function working on a registered probe ID
+int vfc_probe_id_kernel(vfc_probes *probes, size_t id, double val,
+                        double accuracyThreshold, char *mode) {
+
+  if (probes == NULL) {
+    return 1;
+  }
+
+  // The probe uses the copy of the key owned by the interned-string table
+  const char *key = vfc_strintern_str(probes->keys, id);
+  if (key == NULL) {
+    fprintf(stderr, "Error [verificarlo]: unknown probe ID (%zu)\n", id);
+    exit(1);
   }
 
-  // Insert the element in the hashmap
-  vfc_probe_node *newProbe = (vfc_probe_node *)malloc(sizeof(vfc_probe_node));
-  newProbe->key = key;
-  newProbe->value = val;
-  newProbe->accuracyThreshold = accuracyThreshold;
-  newProbe->mode = (char *)malloc(sizeof(char) * (strlen(mode) + 1));
-  strcpy(newProbe->mode, mode);
+  vfc_probe_node *newProbe = NULL;
+  if (probes->stream == NULL) {
+    newProbe = (vfc_probe_node *)vfc_arena_alloc(probes->arena,
+                                                 sizeof(vfc_probe_node));
+    newProbe->key = (char *)key;
+    newProbe->value = val;
+    newProbe->accuracyThreshold = accuracyThreshold;
+    newProbe->mode = vfc_arena_strdup(probes->arena, mode);
+  } else if (!probes->check_duplicates) {
+    vfc_probes_stream_record(probes->stream, key, val, accuracyThreshold,
+                             mode);
+    return 0;
+  }
 
-  vfc_hashmap_insert(probes->map, vfc_hashmap_str_function(key), newProbe);
+  // Insert the element in the hashmap, looking for a duplicate key. In
+  // streaming mode, the hashmap only records the keys already seen.
+  void *item = (newProbe != NULL) ? (void *)newProbe : (void *)key;
+  if (vfc_swisstable_insert(probes->map, id, item) != NULL &&
+      probes->check_duplicates) {
+    fprintf(stderr,
+            "Error [verificarlo]: you have a duplicate error with one of \
+            your probes (\"%s\"). Please make sure to use different names.\n",
+            key);
+    exit(1);
+  }
+
+  if (probes->stream != NULL) {
+    vfc_probes_stream_record(probes->stream, key, val, accuracyThreshold,
+                             mode);
+  }
 
   return 0;
 }
@@ -210,19 +468,183 @@ int vfc_probe_check_relative(vfc_probes *probes, char *testName, char *varName,
                           "relative");
 }
 
-// Return the number of probes stored in the hashmap
+// Similar to vfc_probe, with a registered probe ID
+int vfc_probe_id(vfc_probes *probes, size_t id, double val) {
+  return vfc_probe_id_kernel(probes, id, val, 0, "none");
+}
+
+// Similar to vfc_probe_check, with a registered probe ID
+int vfc_probe_check_id(vfc_probes *probes, size_t id, double val,
+                       double accuracyThreshold) {
+  return vfc_probe_id_kernel(probes, id, val, accuracyThreshold, "absolute");
+}
+
+// Similar to vfc_probe_check_relative, with a registered probe ID
+int vfc_probe_check_relative_id(vfc_probes *probes, size_t id, double val,
+                                double accuracyThreshold) {
+  return vfc_probe_id_kernel(probes, id, val, accuracyThreshold, "relative");
+}
+
+// Return the number of probes stored in the hashmap, or written so far in
+// streaming mode
 unsigned int vfc_num_probes(vfc_probes *probes) {
-  return vfc_hashmap_num_items(probes->map);
+  if (probes->stream != NULL) {
+    return __atomic_load_n(&probes->stream->count, __ATOMIC_RELAXED);
+  }
+  return vfc_swisstable_num_items(probes->map);
+}
+
+// Binary columnar format of the probes file. All the integers and doubles are
+// stored in the byte order of the host (little-endian on all the supported
+// targets), and every column starts on an 8-byte boundary so that it can be
+// mapped in place (e.g. with numpy.memmap):
+//  - header (struct vfc_probes_binary_header)
+//  - value: n_probes doubles
+//  - accuracy_threshold: n_probes doubles
+//  - key: n_probes uint32, index of the probe key in the dictionary
+//  - check_mode: n_probes uint8 (0: none, 1: absolute, 2: relative)
+//  - dictionary: n_keys + 1 uint64 offsets, followed by the keys
+//    ("test,variable") concatenated without separator. Key i spans
+//    [offsets[i], offsets[i + 1]) from the end of the offsets.
+#define VFC_PROBES_BINARY_MAGIC "VFCPROBE"
+#define VFC_PROBES_BINARY_VERSION 1
+
+struct vfc_probes_binary_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t n_keys;
+  uint64_t n_probes;
+  // Offsets of the columns from the start of the file
+  uint64_t value_offset;
+  uint64_t threshold_offset;
+  uint64_t key_offset;
+  uint64_t mode_offset;
+  uint64_t dictionary_offset;
+};
+
+static uint64_t vfc_probes_align8(uint64_t offset) {
+  return (offset + 7) & ~(uint64_t)7;
+}
+
+static uint8_t vfc_probes_mode_code(const char *mode) {
+  if (strcmp(mode, "absolute") == 0) {
+    return 1;
+  }
+  if (strcmp(mode, "relative") == 0) {
+    return 2;
+  }
+  return 0;
 }
 
-// Dump probes in a .csv file (the double values are converted to hex), then
-// free it.
+// Write size bytes at the current position of fp, zero-padded up to offset
+static void vfc_probes_write_column(FILE *fp, const void *data, size_t size,
+                                    uint64_t offset) {
+  static const char padding[8] = {0};
+  long position = ftell(fp);
+  if (position >= 0 && (uint64_t)position < offset) {
+    fwrite(padding, 1, offset - position, fp);
+  }
+  if (size > 0) {
+    fwrite(data, 1, size, fp);
+  }
+}
+
+// Dump the probes in the binary columnar format described above
+static void vfc_dump_probes_binary(vfc_probes *probes, FILE *fp) {
+  const size_t n = vfc_swisstable_num_items(probes->map);
+  const size_t n_keys = vfc_strintern_num_strings(probes->keys);
+
+  double *values = malloc((n + 1) * sizeof(double));
+  double *thresholds = malloc((n + 1) * sizeof(double));
+  uint32_t *keys = malloc((n + 1) * sizeof(uint32_t));
+  uint8_t *modes = malloc(n + 1);
+  uint64_t *offsets = malloc((n_keys + 1) * sizeof(uint64_t));
+  if (values == NULL || thresholds == NULL || keys == NULL || modes == NULL ||
+      offsets == NULL) {
+    fprintf(stderr, "Error [verificarlo]: impossible to allocate the probes \
+            columns\n");
+    exit(1);
+  }
+
+  size_t i = 0;
+  size_t cursor = 0;
+  ISize_t id;
+  void *value;
+  while (i < n && vfc_swisstable_next(probes->map, &cursor, &id, &value)) {
+    vfc_probe_node *probe = (vfc_probe_node *)value;
+    values[i] = probe->value;
+    thresholds[i] = probe->accuracyThreshold;
+    keys[i] = (uint32_t)id;
+    modes[i] = vfc_probes_mode_code(probe->mode);
+    i++;
+  }
+
+  offsets[0] = 0;
+  for (size_t k = 0; k < n_keys; k++) {
+    offsets[k + 1] = offsets[k] + strlen(vfc_strintern_str(probes->keys, k));
+  }
+
+  struct vfc_probes_binary_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, VFC_PROBES_BINARY_MAGIC, sizeof(header.magic));
+  header.version = VFC_PROBES_BINARY_VERSION;
+  header.n_keys = n_keys;
+  header.n_probes = i;
+  header.value_offset = vfc_probes_align8(sizeof(header));
+  header.threshold_offset = header.value_offset + i * sizeof(double);
+  header.key_offset = header.threshold_offset + i * sizeof(double);
+  header.mode_offset = header.key_offset + i * sizeof(uint32_t);
+  header.dictionary_offset = vfc_probes_align8(header.mode_offset + i);
+
+  fwrite(&header, sizeof(header), 1, fp);
+  vfc_probes_write_column(fp, values, i * sizeof(double), header.value_offset);
+  vfc_probes_write_column(fp, thresholds, i * sizeof(double),
+                          header.threshold_offset);
+  vfc_probes_write_column(fp, keys, i * sizeof(uint32_t), header.key_offset);
+  vfc_probes_write_column(fp, modes, i, header.mode_offset);
+  vfc_probes_write_column(fp, offsets, (n_keys + 1) * sizeof(uint64_t),
+                          header.dictionary_offset);
+  for (size_t k = 0; k < n_keys; k++) {
+    fputs(vfc_strintern_str(probes->keys, k), fp);
+  }
+
+  free(values);
+  free(thresholds);
+  free(keys);
+  free(modes);
+  free(offsets);
+}
+
+// Return 1 if the probes must be dumped in the binary format, 0 for CSV
+static int vfc_probes_binary_format(void) {
+  char *format = getenv("VFC_PROBES_FORMAT");
+  if (format == NULL || strcasecmp(format, "csv") == 0) {
+    return 0;
+  }
+  if (strcasecmp(format, "binary") == 0) {
+    return 1;
+  }
+  fprintf(stderr,
+          "Warning [verificarlo]: unknown VFC_PROBES_FORMAT \"%s\", probes \
+          will be dumped as CSV\n",
+          format);
+  return 0;
+}
+
+// Dump probes in a .csv file (the double values are converted to hex), or in
+// the binary columnar format, then free it.
 int vfc_dump_probes(vfc_probes *probes) {
 
   if (probes == NULL) {
     return 1;
   }
 
+  // In streaming mode, the probes are already in the output file
+  if (probes->stream != NULL) {
+    vfc_free_probes(probes);
+    return 0;
+  }
+
   // Get export path from the VFC_PROBES_OUTPUT env variable
   char *exportPath = getenv("VFC_PROBES_OUTPUT");
   if (!exportPath) {
@@ -232,27 +654,35 @@ int vfc_dump_probes(vfc_probes *probes) {
     return 0;
   }
 
-  FILE *fp = fopen(exportPath, "w");
+  const int binary = vfc_probes_binary_format();
+  FILE *fp = fopen(exportPath, binary ? "wb" : "w");
 
   if (fp == NULL) {
     fprintf(stderr,
-            "Error [verificarlo]: impossible to open the CSV file to save your \
+            "Error [verificarlo]: impossible to open the %s file to save your \
             probes (\"%s\")\n",
-            exportPath);
+            binary ? "binary" : "CSV", exportPath);
     exit(1);
   }
 
+  if (binary) {
+    vfc_dump_probes_binary(probes, fp);
+    fflush(fp);
+    fclose(fp);
+    vfc_free_probes(probes);
+    return 0;
+  }
+
   // First line gives the column names
   fprintf(fp, "test,variable,value,accuracy_threshold,check_mode\n");
 
   // Iterate over all table elements
-  vfc_probe_node *probe = NULL;
-  for (size_t i = 0; i < probes->map->capacity; i++) {
-    probe = (vfc_probe_node *)get_value_at(probes->map->items, i);
-    if (probe != NULL) {
-      fprintf(fp, "%s,%a,%a,%s\n", probe->key, probe->value,
-              probe->accuracyThreshold, probe->mode);
-    }
+  size_t cursor = 0;
+  void *value;
+  while (vfc_swisstable_next(probes->map, &cursor, NULL, &value)) {
+    vfc_probe_node *probe = (vfc_probe_node *)value;
+    fprintf(fp, "%s,%a,%a,%s\n", probe->key, probe->value,
+            probe->accuracyThreshold, probe->mode);
   }
 
   fflush(fp);
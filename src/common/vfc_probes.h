@@ -31,7 +31,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "interflop/hashmap/vfc_arena.h"
 #include "interflop/hashmap/vfc_hashmap.h"
+#include "interflop/hashmap/vfc_strintern.h"
+#include "interflop/hashmap/vfc_swisstable.h"
 
 #ifndef VAR_NAME
 #define VAR_NAME(var) #var // Simply returns the name of var into a string
@@ -54,9 +57,17 @@ struct vfc_probe_node {
 
 typedef struct vfc_probe_node vfc_probe_node;
 
-// The probes structure. It simply acts as a wrapper for a Verificarlo hashmap.
+// The probes structure. It simply acts as a wrapper for a Verificarlo
+// concurrent hash table, keyed by the interned ID of the probe keys. The
+// probes are stored in an arena released by vfc_free_probes. In streaming
+// mode, the probes are written to the output file during the run instead and
+// the table only records the keys already seen.
 struct vfc_probes {
-  vfc_hashmap_t map;
+  vfc_swisstable_t map;
+  vfc_strintern_t keys;
+  vfc_arena_t arena;
+  struct vfc_probes_stream *stream;
+  int check_duplicates;
 };
 
 typedef struct vfc_probes vfc_probes;
@@ -92,11 +103,40 @@ int vfc_probe_check(vfc_probes *probes, char *testName, char *varName,
 int vfc_probe_check_relative(vfc_probes *probes, char *testName, char *varName,
                              double val, double accuracyThreshold);
 
-// Return the number of probes stored in the hashmap
+// Register a probe name and return its ID, which can be used with the *_id
+// functions to skip the key generation and lookup on every call
+size_t vfc_probe_register(vfc_probes *probes, char *testName, char *varName);
+
+// Probe kernel function working on a registered probe ID
+int vfc_probe_id_kernel(vfc_probes *probes, size_t id, double val,
+                        double accuracyThreshold, char *mode);
+
+// Similar to vfc_probe, vfc_probe_check and vfc_probe_check_relative, with a
+// probe ID returned by vfc_probe_register
+int vfc_probe_id(vfc_probes *probes, size_t id, double val);
+
+int vfc_probe_check_id(vfc_probes *probes, size_t id, double val,
+                       double accuracyThreshold);
+
+int vfc_probe_check_relative_id(vfc_probes *probes, size_t id, double val,
+                                double accuracyThreshold);
+
+// Return the number of probes stored in the hashmap, or written so far in
+// streaming mode
 unsigned int vfc_num_probes(vfc_probes *probes);
 
-// Dump probes in a .csv file (the double values are converted to hex), then
-// free it.
+// Dump the probes in the file named by VFC_PROBES_OUTPUT, then free them. The
+// VFC_PROBES_FORMAT environment variable selects the format of the file:
+//  - "csv" (default): a "test,variable,value,accuracy_threshold,check_mode"
+//    header, then one line per probe, the doubles being converted to hex
+//  - "binary": a header holding the number of probes and keys and the offset
+//    of each column, then the value and accuracy threshold columns (doubles),
+//    the key column (uint32 index in the dictionary), the check mode column
+//    (uint8: 0 none, 1 absolute, 2 relative) and the dictionary of the
+//    "test,variable" keys. Columns are aligned on 8 bytes and use the byte
+//    order of the host, so they can be mapped in place (see vfc_probes.c)
+// In streaming mode (VFC_PROBES_STREAM), the probes are already written in CSV:
+// the remaining ones are flushed and the file closed.
 int vfc_dump_probes(vfc_probes *probes);
 
 // Fortran wrappers
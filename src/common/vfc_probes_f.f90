@@ -9,19 +9,12 @@ module vfc_probes_f
     end type vfc_probe_node
 
 
-    type, bind(C) :: vfc_hashmap_t
-        integer(kind=C_SIZE_T) :: nbits
-        integer(kind=C_SIZE_T) :: mask
-
-        integer(kind=C_SIZE_T) :: capacity
-        type(C_PTR) :: items
-        integer(kind=C_SIZE_T) :: nitems
-        integer(kind=C_SIZE_T) :: n_deleted_items
-    end type vfc_hashmap_t
-
-
     type, bind(C) :: vfc_probes
         type(C_PTR) :: map
+        type(C_PTR) :: keys
+        type(C_PTR) :: arena
+        type(C_PTR) :: stream
+        integer(C_INT) :: check_duplicates
     end type vfc_probes
 
 
@@ -66,7 +66,10 @@
 
 /* Returns a bool for determining whether an operation should skip */
 /* perturbation. false -> perturb; true -> skip. */
-/* e.g. for sparsity=0.1, all random values > 0.1 = true -> no MCA*/
+/* Each operation is perturbed with probability sparsity. Rather than drawing */
+/* a random number per operation, the number of operations to skip before */
+/* the next perturbed one is drawn from the geometric distribution and */
+/* counted down, so a skipped operation only costs a decrement. */
 /* @param sparsity sparsity */
 /* @param rng_state pointer to the structure holding all the RNG-related data */
 /* @return false -> perturb; true -> skip */
@@ -77,7 +80,18 @@ __attribute__((unused)) static bool _mca_skip_eval(const float sparsity,
     return false;
   }
 
-  return (get_rand_double01(rng_state, global_tid) > sparsity);
+  if (rng_state->skip_count_valid == false) {
+    rng_state->skip_count = get_rand_geometric(rng_state, global_tid, sparsity);
+    rng_state->skip_count_valid = true;
+  }
+
+  if (rng_state->skip_count > 0) {
+    rng_state->skip_count--;
+    return true;
+  }
+
+  rng_state->skip_count = get_rand_geometric(rng_state, global_tid, sparsity);
+  return false;
 }
 
 #endif /* __OPTIONS_H__ */
@@ -0,0 +1,186 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *  Copyright (c) 2019-2026                                                  *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#include "interflop_stdlib.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef __VFC_ARENA_HEADER__
+
+typedef struct vfc_arena_st *vfc_arena_t;
+
+vfc_arena_t vfc_arena_create(void);
+void vfc_arena_destroy(vfc_arena_t arena);
+void *vfc_arena_alloc(vfc_arena_t arena, ISize_t size);
+char *vfc_arena_strdup(vfc_arena_t arena, const char *str);
+
+#endif
+
+/* usable size of a block */
+#define BLOCK_SIZE ((ISize_t)64 * 1024)
+/* larger allocations get a block of their own */
+#define LARGE_SIZE (BLOCK_SIZE / 4)
+#define ALIGNMENT ((ISize_t)16)
+/* threads are spread over the shards in round-robin */
+#define NB_SHARDS 16
+#define CACHE_LINE 64
+
+typedef struct arena_block {
+  struct arena_block *next;
+  ISize_t size;
+  /* bumped without lock, may exceed size when the block is exhausted */
+  ISize_t used;
+  char data[] __attribute__((aligned(16)));
+} arena_block_t;
+
+typedef struct {
+  arena_block_t *current;
+  /* serializes the replacement of the current block */
+  int lock;
+} __attribute__((aligned(CACHE_LINE))) arena_shard_t;
+
+struct vfc_arena_st {
+  arena_shard_t shards[NB_SHARDS];
+};
+
+static int next_shard = 0;
+static __thread int thread_shard = -1;
+
+/***************** Verificarlo arena FUNCTIONS ************************
+ * The following set of functions implement a sharded bump allocator.
+ *********************************************************************/
+
+static arena_shard_t *arena_shard(vfc_arena_t arena) {
+  if (thread_shard < 0) {
+    thread_shard =
+        __atomic_fetch_add(&next_shard, 1, __ATOMIC_RELAXED) % NB_SHARDS;
+  }
+  return &arena->shards[thread_shard];
+}
+
+static void *block_bump(arena_block_t *block, ISize_t size) {
+  if (block == Null) {
+    return Null;
+  }
+  const ISize_t offset =
+      __atomic_fetch_add(&block->used, size, __ATOMIC_RELAXED);
+  if (offset + size > block->size) {
+    return Null;
+  }
+  return block->data + offset;
+}
+
+static arena_block_t *block_create(ISize_t size) {
+  arena_block_t *block = interflop_calloc(1, sizeof(arena_block_t) + size);
+  if (block == Null) {
+    interflop_panic("vfc_arena: cannot allocate memory\n");
+  }
+  block->size = size;
+  return block;
+}
+
+static void shard_lock(arena_shard_t *shard) {
+  int unlocked = 0;
+  while (!__atomic_compare_exchange_n(&shard->lock, &unlocked, 1, 0,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    unlocked = 0;
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+  }
+}
+
+static void shard_unlock(arena_shard_t *shard) {
+  __atomic_store_n(&shard->lock, 0, __ATOMIC_RELEASE);
+}
+
+vfc_arena_t vfc_arena_create(void) {
+  vfc_arena_t arena = interflop_calloc(1, sizeof(struct vfc_arena_st));
+  if (arena == Null) {
+    interflop_panic("vfc_arena: cannot allocate memory\n");
+  }
+  return arena;
+}
+
+void vfc_arena_destroy(vfc_arena_t arena) {
+  if (arena == Null) {
+    return;
+  }
+  for (int i = 0; i < NB_SHARDS; i++) {
+    arena_block_t *block = arena->shards[i].current;
+    while (block != Null) {
+      arena_block_t *next = block->next;
+      interflop_free(block);
+      block = next;
+    }
+  }
+  interflop_free(arena);
+}
+
+void *vfc_arena_alloc(vfc_arena_t arena, ISize_t size) {
+  size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  if (size == 0) {
+    size = ALIGNMENT;
+  }
+
+  arena_shard_t *shard = arena_shard(arena);
+
+  void *ptr = Null;
+  if (size <= LARGE_SIZE) {
+    ptr = block_bump(__atomic_load_n(&shard->current, __ATOMIC_ACQUIRE), size);
+    if (ptr != Null) {
+      return ptr;
+    }
+  }
+
+  shard_lock(shard);
+  arena_block_t *current = shard->current;
+  if (size > LARGE_SIZE) {
+    /* chain the block behind the current one, which remains in use */
+    arena_block_t *block = block_create(size);
+    block->used = size;
+    if (current == Null) {
+      __atomic_store_n(&shard->current, block, __ATOMIC_RELEASE);
+    } else {
+      block->next = current->next;
+      current->next = block;
+    }
+    ptr = block->data;
+  } else {
+    /* another thread of the shard may have replaced the block already */
+    ptr = block_bump(current, size);
+    if (ptr == Null) {
+      arena_block_t *block = block_create(BLOCK_SIZE);
+      block->used = size;
+      block->next = current;
+      __atomic_store_n(&shard->current, block, __ATOMIC_RELEASE);
+      ptr = block->data;
+    }
+  }
+  shard_unlock(shard);
+
+  return ptr;
+}
+
+char *vfc_arena_strdup(vfc_arena_t arena, const char *str) {
+  ISize_t length = 0;
+  while (str[length] != '\0') {
+    length++;
+  }
+  char *copy = vfc_arena_alloc(arena, length + 1);
+  for (ISize_t i = 0; i < length; i++) {
+    copy[i] = str[i];
+  }
+  return copy;
+}
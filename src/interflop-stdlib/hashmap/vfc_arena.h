@@ -0,0 +1,40 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *  Copyright (c) 2019-2026                                                  *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __VFC_ARENA_H__
+#define __VFC_ARENA_H__
+
+#define __VFC_ARENA_HEADER__
+
+#include "interflop/interflop_stdlib.h"
+
+/* Arena allocator for small, long-lived bookkeeping objects.
+ *
+ * Objects are carved out of large blocks obtained with interflop_calloc and
+ * are never freed individually: all the memory of an arena is released at
+ * once by vfc_arena_destroy. Each thread bumps its own block, so concurrent
+ * allocations do not contend and the objects of a thread stay contiguous. */
+typedef struct vfc_arena_st *vfc_arena_t;
+
+// allocate and initialize the arena
+vfc_arena_t vfc_arena_create(void);
+
+// release every object allocated in the arena
+void vfc_arena_destroy(vfc_arena_t arena);
+
+// allocate size bytes aligned on 16 bytes, the memory is zero-initialized
+void *vfc_arena_alloc(vfc_arena_t arena, ISize_t size);
+
+// copy str in the arena
+char *vfc_arena_strdup(vfc_arena_t arena, const char *str);
+
+#endif /* __VFC_ARENA_H__ */
@@ -17,39 +17,14 @@
 
 #include "interflop_stdlib.h"
 
-// #include <stdlib.h>
-
 #define HASH_MULTIPLIER 31
-static const unsigned int hashmap_prime_1 = 73;
-static const unsigned int hashmap_prime_2 = 5009;
 
 #ifndef __VFC_HASHMAP_HEADER__
 
-struct vfc_hashmap_st {
-  ISize_t nbits;
-  ISize_t mask;
-
-  ISize_t capacity;
-  ISize_t *items;
-  ISize_t nitems;
-  ISize_t n_deleted_items;
-};
-typedef struct vfc_hashmap_st *vfc_hashmap_t;
+typedef struct vfc_swisstable_st *vfc_hashmap_t;
 
 // allocate and initialize the map
-vfc_hashmap_t vfc_hashmap_create();
-
-// get the value at an index of a map
-ISize_t get_value_at(ISize_t *items, ISize_t i);
-
-// get the key at an index of a map
-ISize_t get_key_at(ISize_t *items, ISize_t i);
-
-// set the value at an index of a map
-void set_value_at(ISize_t *items, ISize_t value, ISize_t i);
-
-// set the key at an index of a map
-void set_key_at(ISize_t *items, ISize_t key, ISize_t i);
+vfc_hashmap_t vfc_hashmap_create(void);
 
 // free the map
 void vfc_hashmap_destroy(vfc_hashmap_t map);
@@ -69,164 +44,73 @@ void *vfc_hashmap_get(vfc_hashmap_t map, ISize_t key);
 // get the number of elements in the map
 ISize_t vfc_hashmap_num_items(vfc_hashmap_t map);
 
+// iterate over the elements of the map
+char vfc_hashmap_next(vfc_hashmap_t map, ISize_t *cursor, ISize_t *key,
+                      void **item);
+
 // Hash function
 ISize_t vfc_hashmap_str_function(const char *id);
 
 #endif
 
+#ifndef __VFC_SWISSTABLE_HEADER__
+
+typedef struct vfc_swisstable_st *vfc_swisstable_t;
+
+vfc_swisstable_t vfc_swisstable_create(void);
+void vfc_swisstable_destroy(vfc_swisstable_t table);
+void *vfc_swisstable_insert(vfc_swisstable_t table, ISize_t key, void *value);
+void *vfc_swisstable_remove(vfc_swisstable_t table, ISize_t key);
+IBool vfc_swisstable_have(vfc_swisstable_t table, ISize_t key);
+void *vfc_swisstable_get(vfc_swisstable_t table, ISize_t key);
+ISize_t vfc_swisstable_num_items(vfc_swisstable_t table);
+IBool vfc_swisstable_next(vfc_swisstable_t table, ISize_t *cursor,
+                          ISize_t *key, void **value);
+
+#endif
+
 /***************** Verificarlo hashmap FUNCTIONS ********************
  * The following set of functions are used in backends and wrapper
- * to stock and access quickly internal data.
+ * to stock and access quickly internal data. They forward to the
+ * concurrent vfc_swisstable.
  *******************************************************************/
 
 // free the map
-void vfc_hashmap_destroy(vfc_hashmap_t map) {
-  if (map) {
-    interflop_free(map->items);
-  }
-  interflop_free(map);
-}
+void vfc_hashmap_destroy(vfc_hashmap_t map) { vfc_swisstable_destroy(map); }
 
 // allocate and initialize the map
-vfc_hashmap_t vfc_hashmap_create() {
-  vfc_hashmap_t map =
-      (vfc_hashmap_t)interflop_calloc(1, sizeof(struct vfc_hashmap_st));
-
-  if (map == Null) {
-    return Null;
-  }
-  map->nbits = 3;
-  map->capacity = (ISize_t)(1 << map->nbits);
-  map->mask = map->capacity - 1;
-  // an item is now a value and a key
-  map->items = (ISize_t *)interflop_calloc(map->capacity, 2 * sizeof(ISize_t));
-  if (map->items == Null) {
-    vfc_hashmap_destroy(map);
-    return Null;
-  }
-  map->nitems = 0;
-  map->n_deleted_items = 0;
-  return map;
-}
-
-ISize_t get_value_at(ISize_t *items, ISize_t i) { return items[i * 2]; }
-
-ISize_t get_key_at(ISize_t *items, ISize_t i) { return items[(i * 2) + 1]; }
-
-void set_value_at(ISize_t *items, ISize_t value, ISize_t i) {
-  items[i * 2] = value;
-}
-
-void set_key_at(ISize_t *items, ISize_t key, ISize_t i) {
-  items[(i * 2) + 1] = key;
-}
-
-// add a member in the table
-static int hashmap_add_member(vfc_hashmap_t map, ISize_t key, void *item) {
-  ISize_t value = (ISize_t)item;
-  ISize_t ii;
-
-  if (value == 0 || value == 1) {
-    return -1;
-  }
-
-  ii = map->mask & (hashmap_prime_1 * key);
-
-  while (get_value_at(map->items, ii) != 0 &&
-         get_value_at(map->items, ii) != 1) {
-    if (get_value_at(map->items, ii) == value) {
-      return 0;
-    } else {
-      /* search free slot */
-      ii = map->mask & (ii + hashmap_prime_2);
-    }
-  }
-  map->nitems++;
-  if (get_value_at(map->items, ii) == 1) {
-    map->n_deleted_items--;
-  }
-
-  set_value_at(map->items, value, ii);
-  set_key_at(map->items, key, ii);
-
-  return 1;
-}
-
-// rehash the table if necessary
-static void maybe_rehash_map(vfc_hashmap_t map) {
-  ISize_t *old_items;
-  ISize_t old_capacity, ii;
-
-  if (map->nitems + map->n_deleted_items >= (double)map->capacity * 0.85) {
-    old_items = map->items;
-    old_capacity = map->capacity;
-    map->nbits++;
-    map->capacity = (ISize_t)(1 << map->nbits);
-    map->mask = map->capacity - 1;
-    map->items =
-        (ISize_t *)interflop_calloc(map->capacity, 2 * sizeof(ISize_t));
-    map->nitems = 0;
-    map->n_deleted_items = 0;
-    for (ii = 0; ii < old_capacity; ii++) {
-      hashmap_add_member(map, get_key_at(old_items, ii),
-                         (void *)get_value_at(old_items, ii));
-    }
-    interflop_free(old_items);
-  }
-}
+vfc_hashmap_t vfc_hashmap_create(void) { return vfc_swisstable_create(); }
 
 // insert an element in the map
 void vfc_hashmap_insert(vfc_hashmap_t map, ISize_t key, void *item) {
-  hashmap_add_member(map, key, item);
-  maybe_rehash_map(map);
+  vfc_swisstable_insert(map, key, item);
 }
 
 // remove an element of the map
 void vfc_hashmap_remove(vfc_hashmap_t map, ISize_t key) {
-  ISize_t ii = map->mask & (hashmap_prime_1 * key);
-
-  while (get_value_at(map->items, ii) != 0) {
-    if (get_key_at(map->items, ii) == key) {
-      set_value_at(map->items, 1, ii);
-      map->nitems--;
-      map->n_deleted_items++;
-      break;
-    } else {
-      ii = map->mask & (ii + hashmap_prime_2);
-    }
-  }
+  vfc_swisstable_remove(map, key);
 }
 
 // test if an element is in the map
 char vfc_hashmap_have(vfc_hashmap_t map, ISize_t key) {
-  ISize_t ii = map->mask & (hashmap_prime_1 * key);
-
-  while (get_value_at(map->items, ii) != 0) {
-    if (get_key_at(map->items, ii) == key) {
-      return 1;
-    } else {
-      ii = map->mask & (ii + hashmap_prime_2);
-    }
-  }
-  return 0;
+  return vfc_swisstable_have(map, key) ? 1 : 0;
 }
 
 // get an element of the map
 void *vfc_hashmap_get(vfc_hashmap_t map, ISize_t key) {
-  ISize_t ii = map->mask & (hashmap_prime_1 * key);
-
-  while (get_value_at(map->items, ii) != 0) {
-    if (get_key_at(map->items, ii) == key) {
-      return (void *)get_value_at(map->items, ii);
-    } else {
-      ii = map->mask & (ii + hashmap_prime_2);
-    }
-  }
-  return Null;
+  return vfc_swisstable_get(map, key);
 }
 
 // get the number of elements in the map
-ISize_t vfc_hashmap_num_items(vfc_hashmap_t map) { return map->nitems; }
+ISize_t vfc_hashmap_num_items(vfc_hashmap_t map) {
+  return vfc_swisstable_num_items(map);
+}
+
+// iterate over the elements of the map
+char vfc_hashmap_next(vfc_hashmap_t map, ISize_t *cursor, ISize_t *key,
+                      void **item) {
+  return vfc_swisstable_next(map, cursor, key, item) ? 1 : 0;
+}
 
 // Hash function for strings
 ISize_t vfc_hashmap_str_function(const char *id) {
@@ -244,9 +128,11 @@ ISize_t vfc_hashmap_str_function(const char *id) {
   return index;
 }
 
-// Free the hashmap
+// Free the elements of the hashmap
 void vfc_hashmap_free(vfc_hashmap_t map) {
-  for (ISize_t ii = 0; ii < map->capacity; ii++)
-    if (get_value_at(map->items, ii) != 0 && get_value_at(map->items, ii) != 0)
-      interflop_free((void *)get_value_at(map->items, ii));
-}
\ No newline at end of file
+  ISize_t cursor = 0;
+  void *item;
+  while (vfc_swisstable_next(map, &cursor, Null, &item)) {
+    interflop_free(item);
+  }
+}
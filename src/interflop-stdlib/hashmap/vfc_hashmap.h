@@ -20,38 +20,20 @@
 
 #define __VFC_HASHMAP_HEADER__
 
+#include "interflop/hashmap/vfc_swisstable.h"
 #include "interflop/interflop_stdlib.h"
 
-struct vfc_hashmap_st {
-  ISize_t nbits;
-  ISize_t mask;
-
-  ISize_t capacity;
-  ISize_t *items;
-  ISize_t nitems;
-  ISize_t n_deleted_items;
-};
-typedef struct vfc_hashmap_st *vfc_hashmap_t;
+/* vfc_hashmap is a thin layer over vfc_swisstable kept for compatibility;
+ * the map is safe to use concurrently from several threads */
+typedef struct vfc_swisstable_st *vfc_hashmap_t;
 
 // allocate and initialize the map
 vfc_hashmap_t vfc_hashmap_create(void);
 
-// get the value at an index of a map
-ISize_t get_value_at(ISize_t *items, ISize_t i);
-
-// get the key at an index of a map
-ISize_t get_key_at(ISize_t *items, ISize_t i);
-
-// set the value at an index of a map
-void set_value_at(ISize_t *items, ISize_t value, ISize_t i);
-
-// set the key at an index of a map
-void set_key_at(ISize_t *items, ISize_t key, ISize_t i);
-
 // free the map
 void vfc_hashmap_destroy(vfc_hashmap_t map);
 
-// insert an element in the map
+// insert an element in the map, replacing the element with the same key
 void vfc_hashmap_insert(vfc_hashmap_t map, ISize_t key, void *item);
 
 // remove an element of the map
@@ -66,10 +48,14 @@ void *vfc_hashmap_get(vfc_hashmap_t map, ISize_t key);
 // get the number of elements in the map
 ISize_t vfc_hashmap_num_items(vfc_hashmap_t map);
 
+// iterate over the elements of the map, cursor must be initialized to 0
+char vfc_hashmap_next(vfc_hashmap_t map, ISize_t *cursor, ISize_t *key,
+                      void **item);
+
 // Hash function for strings
 ISize_t vfc_hashmap_str_function(const char *id);
 
-// Free the hashmap
+// Free the elements of the hashmap
 void vfc_hashmap_free(vfc_hashmap_t map);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,237 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *  Copyright (c) 2019-2026                                                  *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#include "interflop_stdlib.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef __VFC_SWISSTABLE_HEADER__
+
+typedef struct vfc_swisstable_st *vfc_swisstable_t;
+
+vfc_swisstable_t vfc_swisstable_create(void);
+void vfc_swisstable_destroy(vfc_swisstable_t table);
+void *vfc_swisstable_insert(vfc_swisstable_t table, ISize_t key, void *value);
+void *vfc_swisstable_get(vfc_swisstable_t table, ISize_t key);
+
+#endif
+
+#ifndef __VFC_STRINTERN_HEADER__
+
+typedef struct vfc_strintern_st *vfc_strintern_t;
+
+#define VFC_STRINTERN_NONE ((ISize_t)-1)
+
+vfc_strintern_t vfc_strintern_create(void);
+void vfc_strintern_destroy(vfc_strintern_t table);
+ISize_t vfc_strintern_id(vfc_strintern_t table, const char *str);
+ISize_t vfc_strintern_lookup(vfc_strintern_t table, const char *str);
+const char *vfc_strintern_str(vfc_strintern_t table, ISize_t id);
+ISize_t vfc_strintern_num_strings(vfc_strintern_t table);
+
+#endif
+
+/* The ID -> string directory is split in chunks of growing size so that it
+ * never moves: chunk k holds FIRST_CHUNK_SIZE << k entries */
+#define FIRST_CHUNK_BITS 6
+#define FIRST_CHUNK_SIZE ((ISize_t)1 << FIRST_CHUNK_BITS)
+#define MAX_CHUNKS (64 - FIRST_CHUNK_BITS)
+
+typedef struct strintern_entry {
+  /* next entry whose string has the same hash */
+  struct strintern_entry *next;
+  ISize_t id;
+  ISize_t length;
+  char str[];
+} strintern_entry_t;
+
+struct vfc_strintern_st {
+  /* string hash -> first entry with this hash */
+  vfc_swisstable_t map;
+  strintern_entry_t **chunks[MAX_CHUNKS];
+  ISize_t count;
+  int lock;
+};
+
+/***************** Verificarlo strintern FUNCTIONS ********************
+ * The following set of functions implement an interned-string table
+ * on top of vfc_swisstable.
+ *********************************************************************/
+
+/* FNV-1a hash of str, also returns its length */
+static ISize_t strintern_hash(const char *str, ISize_t *length) {
+  IUint64_t hash = 0xcbf29ce484222325ULL;
+  const unsigned char *p = (const unsigned char *)str;
+  while (*p) {
+    hash ^= *p++;
+    hash *= 0x100000001b3ULL;
+  }
+  *length = (ISize_t)((const char *)p - str);
+  return (ISize_t)hash;
+}
+
+static IBool strintern_equal(const strintern_entry_t *entry, const char *str,
+                             ISize_t length) {
+  if (entry->length != length) {
+    return IFalse;
+  }
+  for (ISize_t i = 0; i < length; i++) {
+    if (entry->str[i] != str[i]) {
+      return IFalse;
+    }
+  }
+  return ITrue;
+}
+
+static strintern_entry_t *strintern_find(vfc_strintern_t table,
+                                         const char *str, ISize_t hash,
+                                         ISize_t length) {
+  strintern_entry_t *entry = vfc_swisstable_get(table->map, hash);
+  while (entry != Null) {
+    if (strintern_equal(entry, str, length)) {
+      return entry;
+    }
+    entry = __atomic_load_n(&entry->next, __ATOMIC_ACQUIRE);
+  }
+  return Null;
+}
+
+/* position of id in the directory */
+static void strintern_locate(ISize_t id, ISize_t *chunk, ISize_t *offset) {
+  const ISize_t p = id + FIRST_CHUNK_SIZE;
+  const int msb = 63 - __builtin_clzll((unsigned long long)p);
+  *chunk = msb - FIRST_CHUNK_BITS;
+  *offset = p - ((ISize_t)1 << msb);
+}
+
+static void strintern_lock(vfc_strintern_t table) {
+  int unlocked = 0;
+  while (!__atomic_compare_exchange_n(&table->lock, &unlocked, 1, 0,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    unlocked = 0;
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+  }
+}
+
+static void strintern_unlock(vfc_strintern_t table) {
+  __atomic_store_n(&table->lock, 0, __ATOMIC_RELEASE);
+}
+
+vfc_strintern_t vfc_strintern_create(void) {
+  vfc_strintern_t table = interflop_calloc(1, sizeof(struct vfc_strintern_st));
+  if (table == Null) {
+    interflop_panic("vfc_strintern: cannot allocate memory\n");
+  }
+  table->map = vfc_swisstable_create();
+  return table;
+}
+
+void vfc_strintern_destroy(vfc_strintern_t table) {
+  if (table == Null) {
+    return;
+  }
+  for (ISize_t id = 0; id < table->count; id++) {
+    ISize_t chunk, offset;
+    strintern_locate(id, &chunk, &offset);
+    interflop_free(table->chunks[chunk][offset]);
+  }
+  for (int k = 0; k < MAX_CHUNKS; k++) {
+    if (table->chunks[k] != Null) {
+      interflop_free(table->chunks[k]);
+    }
+  }
+  vfc_swisstable_destroy(table->map);
+  interflop_free(table);
+}
+
+ISize_t vfc_strintern_lookup(vfc_strintern_t table, const char *str) {
+  ISize_t length;
+  const ISize_t hash = strintern_hash(str, &length);
+  const strintern_entry_t *entry = strintern_find(table, str, hash, length);
+  return (entry == Null) ? VFC_STRINTERN_NONE : entry->id;
+}
+
+ISize_t vfc_strintern_id(vfc_strintern_t table, const char *str) {
+  ISize_t length;
+  const ISize_t hash = strintern_hash(str, &length);
+  strintern_entry_t *entry = strintern_find(table, str, hash, length);
+  if (entry != Null) {
+    return entry->id;
+  }
+
+  strintern_lock(table);
+
+  /* another thread may have interned str since the first lookup */
+  strintern_entry_t *head = vfc_swisstable_get(table->map, hash);
+  strintern_entry_t *tail = Null;
+  for (entry = head; entry != Null; entry = entry->next) {
+    if (strintern_equal(entry, str, length)) {
+      strintern_unlock(table);
+      return entry->id;
+    }
+    tail = entry;
+  }
+
+  const ISize_t id = table->count;
+  ISize_t chunk, offset;
+  strintern_locate(id, &chunk, &offset);
+  if (table->chunks[chunk] == Null) {
+    table->chunks[chunk] = interflop_calloc(FIRST_CHUNK_SIZE << chunk,
+                                            sizeof(strintern_entry_t *));
+    if (table->chunks[chunk] == Null) {
+      interflop_panic("vfc_strintern: cannot allocate memory\n");
+    }
+  }
+
+  entry = interflop_malloc(sizeof(strintern_entry_t) + length + 1);
+  if (entry == Null) {
+    interflop_panic("vfc_strintern: cannot allocate memory\n");
+  }
+  entry->next = Null;
+  entry->id = id;
+  entry->length = length;
+  for (ISize_t i = 0; i <= length; i++) {
+    entry->str[i] = str[i];
+  }
+
+  /* publish the directory slot before the count and the entry before
+   * linking it, so lock-free readers only see complete entries */
+  __atomic_store_n(&table->chunks[chunk][offset], entry, __ATOMIC_RELEASE);
+  if (tail == Null) {
+    vfc_swisstable_insert(table->map, hash, entry);
+  } else {
+    __atomic_store_n(&tail->next, entry, __ATOMIC_RELEASE);
+  }
+  __atomic_store_n(&table->count, id + 1, __ATOMIC_RELEASE);
+
+  strintern_unlock(table);
+  return id;
+}
+
+const char *vfc_strintern_str(vfc_strintern_t table, ISize_t id) {
+  if (id >= __atomic_load_n(&table->count, __ATOMIC_ACQUIRE)) {
+    return Null;
+  }
+  ISize_t chunk, offset;
+  strintern_locate(id, &chunk, &offset);
+  const strintern_entry_t *entry =
+      __atomic_load_n(&table->chunks[chunk][offset], __ATOMIC_ACQUIRE);
+  return entry->str;
+}
+
+ISize_t vfc_strintern_num_strings(vfc_strintern_t table) {
+  return __atomic_load_n(&table->count, __ATOMIC_ACQUIRE);
+}
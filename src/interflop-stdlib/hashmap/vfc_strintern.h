@@ -0,0 +1,51 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *  Copyright (c) 2019-2026                                                  *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __VFC_STRINTERN_H__
+#define __VFC_STRINTERN_H__
+
+#define __VFC_STRINTERN_HEADER__
+
+#include "interflop/interflop_stdlib.h"
+
+/* Interned-string table giving each distinct string a stable, dense ID
+ * (0, 1, 2, ... in order of first insertion).
+ *
+ * A string is resolved with a single hash computation followed by a full
+ * comparison against the strings sharing its hash, so two different
+ * strings never alias. The table keeps its own copy of every string; the
+ * copies live until the table is destroyed. Lookups are lock-free,
+ * insertions of new strings are serialized. */
+typedef struct vfc_strintern_st *vfc_strintern_t;
+
+/* returned by vfc_strintern_lookup for strings not in the table */
+#define VFC_STRINTERN_NONE ((ISize_t)-1)
+
+// allocate and initialize the table
+vfc_strintern_t vfc_strintern_create(void);
+
+// free the table and its copies of the strings
+void vfc_strintern_destroy(vfc_strintern_t table);
+
+// return the ID of str, interning it first if needed
+ISize_t vfc_strintern_id(vfc_strintern_t table, const char *str);
+
+// return the ID of str, VFC_STRINTERN_NONE if it was never interned
+ISize_t vfc_strintern_lookup(vfc_strintern_t table, const char *str);
+
+// return the interned copy of the string with the given ID, Null if unknown
+const char *vfc_strintern_str(vfc_strintern_t table, ISize_t id);
+
+// get the number of interned strings, IDs range from 0 to this value - 1
+ISize_t vfc_strintern_num_strings(vfc_strintern_t table);
+
+#endif /* __VFC_STRINTERN_H__ */
@@ -0,0 +1,480 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *  Copyright (c) 2019-2026                                                  *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#include "interflop_stdlib.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef __VFC_SWISSTABLE_HEADER__
+
+typedef struct vfc_swisstable_st *vfc_swisstable_t;
+
+vfc_swisstable_t vfc_swisstable_create(void);
+void vfc_swisstable_destroy(vfc_swisstable_t table);
+void *vfc_swisstable_insert(vfc_swisstable_t table, ISize_t key, void *value);
+void *vfc_swisstable_insert_if_absent(vfc_swisstable_t table, ISize_t key,
+                                      void *value);
+void *vfc_swisstable_remove(vfc_swisstable_t table, ISize_t key);
+IBool vfc_swisstable_have(vfc_swisstable_t table, ISize_t key);
+void *vfc_swisstable_get(vfc_swisstable_t table, ISize_t key);
+ISize_t vfc_swisstable_num_items(vfc_swisstable_t table);
+IBool vfc_swisstable_next(vfc_swisstable_t table, ISize_t *cursor,
+                          ISize_t *key, void **value);
+IUint64_t vfc_swisstable_mix64(IUint64_t x);
+
+#endif
+
+/* number of slots probed at once */
+#define GROUP_SIZE 16
+/* initial number of slots */
+#define INITIAL_CAPACITY (2 * GROUP_SIZE)
+
+/* Metadata bytes: a full slot holds the 7 low bits of the hash (high bit
+ * clear), the other states have the high bit set */
+#define CTRL_EMPTY 0x80
+#define CTRL_DELETED 0xFE
+#define CTRL_BUSY 0xFF /* claimed by a writer, key not published yet */
+
+#define IS_FULL(C) (((C)&0x80) == 0)
+
+/* Value of a full slot whose element is being removed. The remover swaps it
+ * in before marking the slot deleted, so that a concurrent replacement can
+ * tell that the element is gone rather than store its value in a removed
+ * slot. Its address cannot be a value of the caller. */
+static char removed_value;
+#define REMOVED ((void *)&removed_value)
+
+typedef struct {
+  ISize_t key;
+  void *value;
+} slot_t;
+
+/* One generation of the table. When a generation is full, writers freeze
+ * it and migrate its content to a new one, sized for its live elements; old
+ * generations are kept until the table is destroyed since lock-free readers
+ * may still use them */
+typedef struct table_array {
+  ISize_t capacity;
+  ISize_t group_mask;
+  /* maximal number of claimed slots (full or deleted) before growing */
+  ISize_t max_used;
+  ISize_t used;
+  /* number of writers currently working on this generation */
+  ISize_t writers;
+  int frozen;
+  unsigned char *ctrl;
+  slot_t *slots;
+  struct table_array *prev;
+} table_array_t;
+
+struct vfc_swisstable_st {
+  table_array_t *array;
+  ISize_t nitems;
+  int resize_lock;
+};
+
+typedef enum { FOUND, INSERTED, NEED_RESIZE, RETRY } insert_status;
+
+/***************** Verificarlo swisstable FUNCTIONS ********************
+ * The following set of functions implement a concurrent hash table
+ * probed by groups of metadata bytes.
+ *********************************************************************/
+
+/* Finalizer of MurmurHash3, gives full avalanche on 64-bit keys */
+IUint64_t vfc_swisstable_mix64(IUint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/* SIMD group loads race with the atomic updates of the metadata bytes,
+ * which is benign but reported by ThreadSanitizer */
+#if defined(__SSE2__) && !defined(__SANITIZE_THREAD__)
+#define SWISSTABLE_SSE2
+#endif
+
+/* Returns a bitmask of the slots of the group whose metadata equals h.
+ * Metadata bytes may be updated concurrently, callers must re-check the
+ * matched slots with an atomic load */
+static inline unsigned int group_match(const unsigned char *ctrl,
+                                       unsigned char h) {
+#if defined(SWISSTABLE_SSE2)
+  const __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (unsigned int)_mm_movemask_epi8(
+      _mm_cmpeq_epi8(group, _mm_set1_epi8((char)h)));
+#else
+  unsigned int match = 0;
+  for (int i = 0; i < GROUP_SIZE; i++) {
+    match |= (unsigned int)(__atomic_load_n(&ctrl[i], __ATOMIC_RELAXED) == h)
+             << i;
+  }
+  return match;
+#endif
+}
+
+static inline unsigned char load_ctrl(const table_array_t *array, ISize_t i) {
+  return __atomic_load_n(&array->ctrl[i], __ATOMIC_ACQUIRE);
+}
+
+/* Waits for a writer to publish the slot i, returns its metadata */
+static inline unsigned char wait_ctrl(const table_array_t *array, ISize_t i) {
+  unsigned char c;
+  while ((c = load_ctrl(array, i)) == CTRL_BUSY) {
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+  }
+  return c;
+}
+
+static table_array_t *array_create(ISize_t capacity) {
+  table_array_t *array =
+      (table_array_t *)interflop_calloc(1, sizeof(table_array_t));
+  if (array == Null) {
+    return Null;
+  }
+  array->capacity = capacity;
+  array->group_mask = capacity / GROUP_SIZE - 1;
+  array->max_used = capacity - capacity / 8;
+  array->ctrl = (unsigned char *)interflop_malloc(capacity);
+  array->slots = (slot_t *)interflop_calloc(capacity, sizeof(slot_t));
+  if (array->ctrl == Null || array->slots == Null) {
+    interflop_free(array->ctrl);
+    interflop_free(array->slots);
+    interflop_free(array);
+    return Null;
+  }
+  for (ISize_t i = 0; i < capacity; i++) {
+    array->ctrl[i] = CTRL_EMPTY;
+  }
+  return array;
+}
+
+static void array_destroy(table_array_t *array) {
+  while (array) {
+    table_array_t *prev = array->prev;
+    interflop_free(array->ctrl);
+    interflop_free(array->slots);
+    interflop_free(array);
+    array = prev;
+  }
+}
+
+/* Reserves room for one more claimed slot */
+static inline IBool array_reserve(table_array_t *array) {
+  if (__atomic_add_fetch(&array->used, 1, __ATOMIC_RELAXED) >
+      array->max_used) {
+    __atomic_sub_fetch(&array->used, 1, __ATOMIC_RELAXED);
+    return IFalse;
+  }
+  return ITrue;
+}
+
+/* Looks for key in the group starting at base among the slots of mask */
+static inline ISize_t group_find(const table_array_t *array, ISize_t base,
+                                 unsigned int mask, unsigned char h2,
+                                 ISize_t key, IBool wait) {
+  while (mask) {
+    const ISize_t i = base + __builtin_ctz(mask);
+    const unsigned char c = wait ? wait_ctrl(array, i) : load_ctrl(array, i);
+    if (c == h2 && array->slots[i].key == key) {
+      return i;
+    }
+    mask &= mask - 1;
+  }
+  return array->capacity;
+}
+
+/* Returns the index of key in array, or array->capacity if absent */
+static ISize_t array_find(const table_array_t *array, ISize_t key) {
+  const IUint64_t hash = vfc_swisstable_mix64(key);
+  const unsigned char h2 = hash & 0x7F;
+  ISize_t group = (hash >> 7) & array->group_mask;
+
+  for (ISize_t probe = 0; probe <= array->group_mask; probe++) {
+    const ISize_t base = group * GROUP_SIZE;
+    const unsigned char *ctrl = &array->ctrl[base];
+    const ISize_t i =
+        group_find(array, base, group_match(ctrl, h2), h2, key, IFalse);
+    if (i != array->capacity) {
+      return i;
+    }
+    if (group_match(ctrl, CTRL_EMPTY)) {
+      break;
+    }
+    /* triangular probing visits every group once */
+    group = (group + probe + 1) & array->group_mask;
+  }
+  return array->capacity;
+}
+
+/* Inserts key in array. Writers only claim empty slots, never tombstones,
+ * in increasing order within a group, and wait for the slots being claimed
+ * on their probe sequence: two writers of the same key therefore always
+ * meet on the same slot. Returns RETRY when the key is found in a slot being
+ * removed, which is marked deleted before the remover leaves. */
+static insert_status array_insert(table_array_t *array, ISize_t key,
+                                  void *value, IBool replace, void **found) {
+  const IUint64_t hash = vfc_swisstable_mix64(key);
+  const unsigned char h2 = hash & 0x7F;
+  ISize_t group = (hash >> 7) & array->group_mask;
+
+  for (ISize_t probe = 0; probe <= array->group_mask; probe++) {
+    const ISize_t base = group * GROUP_SIZE;
+    const unsigned char *ctrl = &array->ctrl[base];
+    /* empty slots must be collected first: a slot claimed after this point
+     * is either tried below or seen as a candidate */
+    unsigned int empty = group_match(ctrl, CTRL_EMPTY);
+    const unsigned int candidates =
+        group_match(ctrl, h2) | group_match(ctrl, CTRL_BUSY);
+
+    ISize_t i = group_find(array, base, candidates, h2, key, ITrue);
+    while (i == array->capacity && empty) {
+      const ISize_t j = base + __builtin_ctz(empty);
+      unsigned char expected = CTRL_EMPTY;
+      if (!array_reserve(array)) {
+        return NEED_RESIZE;
+      }
+      if (__atomic_compare_exchange_n(&array->ctrl[j], &expected, CTRL_BUSY,
+                                      0, __ATOMIC_ACQ_REL,
+                                      __ATOMIC_ACQUIRE)) {
+        array->slots[j].key = key;
+        __atomic_store_n(&array->slots[j].value, value, __ATOMIC_RELAXED);
+        __atomic_store_n(&array->ctrl[j], h2, __ATOMIC_RELEASE);
+        *found = Null;
+        return INSERTED;
+      }
+      /* lost the slot: the winner may be inserting the same key */
+      __atomic_sub_fetch(&array->used, 1, __ATOMIC_RELAXED);
+      i = group_find(array, base, 1U << (j - base), h2, key, ITrue);
+      empty &= empty - 1;
+    }
+    if (i != array->capacity) {
+      void *old = __atomic_load_n(&array->slots[i].value, __ATOMIC_ACQUIRE);
+      /* the value is only replaced as long as the element is not removed */
+      while (old != REMOVED && replace &&
+             !__atomic_compare_exchange_n(&array->slots[i].value, &old, value,
+                                          0, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE)) {
+      }
+      if (old == REMOVED) {
+        return RETRY;
+      }
+      *found = old;
+      return FOUND;
+    }
+    group = (group + probe + 1) & array->group_mask;
+  }
+  return NEED_RESIZE;
+}
+
+/* Registers the caller as a writer of the current generation */
+static table_array_t *writer_enter(vfc_swisstable_t table) {
+  for (;;) {
+    table_array_t *array = __atomic_load_n(&table->array, __ATOMIC_ACQUIRE);
+    __atomic_add_fetch(&array->writers, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&array->frozen, __ATOMIC_SEQ_CST)) {
+      return array;
+    }
+    /* a migration is in progress, wait for the next generation */
+    __atomic_sub_fetch(&array->writers, 1, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&table->array, __ATOMIC_ACQUIRE) == array) {
+#if defined(__SSE2__)
+      _mm_pause();
+#endif
+    }
+  }
+}
+
+static inline void writer_exit(table_array_t *array) {
+  __atomic_sub_fetch(&array->writers, 1, __ATOMIC_RELEASE);
+}
+
+/* Migrates the full slots of array to a new generation sized for the live
+ * elements. Only one thread migrates, the others wait in writer_enter. */
+static void table_grow(vfc_swisstable_t table, table_array_t *array) {
+  int unlocked = 0;
+  if (!__atomic_compare_exchange_n(&table->resize_lock, &unlocked, 1, 0,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    return;
+  }
+  if (__atomic_load_n(&table->array, __ATOMIC_ACQUIRE) != array) {
+    __atomic_store_n(&table->resize_lock, 0, __ATOMIC_RELEASE);
+    return;
+  }
+
+  __atomic_store_n(&array->frozen, 1, __ATOMIC_SEQ_CST);
+  while (__atomic_load_n(&array->writers, __ATOMIC_SEQ_CST) != 0) {
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+  }
+
+  /* keep the load factor under one half after the migration */
+  ISize_t live = 0;
+  for (ISize_t i = 0; i < array->capacity; i++) {
+    live += IS_FULL(array->ctrl[i]);
+  }
+  ISize_t capacity = array->capacity;
+  while (2 * live + GROUP_SIZE > capacity) {
+    capacity *= 2;
+  }
+  table_array_t *next = array_create(capacity);
+  if (next == Null) {
+    interflop_panic("vfc_swisstable: cannot allocate memory\n");
+  }
+
+  for (ISize_t i = 0; i < array->capacity; i++) {
+    if (IS_FULL(array->ctrl[i])) {
+      void *found;
+      array_insert(next, array->slots[i].key, array->slots[i].value, ITrue,
+                   &found);
+    }
+  }
+  next->prev = array;
+
+  __atomic_store_n(&table->array, next, __ATOMIC_RELEASE);
+  __atomic_store_n(&table->resize_lock, 0, __ATOMIC_RELEASE);
+}
+
+static void *table_insert(vfc_swisstable_t table, ISize_t key, void *value,
+                          IBool replace) {
+  void *found = Null;
+  for (;;) {
+    table_array_t *array = writer_enter(table);
+    const insert_status status =
+        array_insert(array, key, value, replace, &found);
+    if (status == INSERTED) {
+      __atomic_add_fetch(&table->nitems, 1, __ATOMIC_RELAXED);
+    }
+    writer_exit(array);
+    if (status == INSERTED) {
+      return replace ? Null : value;
+    } else if (status == FOUND) {
+      return found;
+    } else if (status == NEED_RESIZE) {
+      table_grow(table, array);
+    }
+  }
+}
+
+// allocate and initialize the table
+vfc_swisstable_t vfc_swisstable_create(void) {
+  vfc_swisstable_t table = (vfc_swisstable_t)interflop_calloc(
+      1, sizeof(struct vfc_swisstable_st));
+  if (table == Null) {
+    return Null;
+  }
+  table->array = array_create(INITIAL_CAPACITY);
+  if (table->array == Null) {
+    interflop_free(table);
+    return Null;
+  }
+  return table;
+}
+
+// free the table, the values are not freed
+void vfc_swisstable_destroy(vfc_swisstable_t table) {
+  if (table) {
+    array_destroy(table->array);
+  }
+  interflop_free(table);
+}
+
+// insert or replace an element, returns the replaced value or Null
+void *vfc_swisstable_insert(vfc_swisstable_t table, ISize_t key, void *value) {
+  return table_insert(table, key, value, ITrue);
+}
+
+// insert an element if the key is absent, returns the value in the table
+void *vfc_swisstable_insert_if_absent(vfc_swisstable_t table, ISize_t key,
+                                      void *value) {
+  return table_insert(table, key, value, IFalse);
+}
+
+// remove an element, returns the removed value or Null
+void *vfc_swisstable_remove(vfc_swisstable_t table, ISize_t key) {
+  table_array_t *array = writer_enter(table);
+  void *value = Null;
+  const ISize_t i = array_find(array, key);
+  if (i != array->capacity) {
+    /* the first writer to swap REMOVED in owns the removal, replacements
+     * seeing it insert the key again once the slot is deleted */
+    value = __atomic_load_n(&array->slots[i].value, __ATOMIC_ACQUIRE);
+    while (value != REMOVED &&
+           !__atomic_compare_exchange_n(&array->slots[i].value, &value,
+                                        REMOVED, 0, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)) {
+    }
+    if (value == REMOVED) {
+      value = Null;
+    } else {
+      __atomic_store_n(&array->ctrl[i], CTRL_DELETED, __ATOMIC_RELEASE);
+      __atomic_sub_fetch(&table->nitems, 1, __ATOMIC_RELAXED);
+    }
+  }
+  writer_exit(array);
+  return value;
+}
+
+// test if an element is in the table
+IBool vfc_swisstable_have(vfc_swisstable_t table, ISize_t key) {
+  table_array_t *array = __atomic_load_n(&table->array, __ATOMIC_ACQUIRE);
+  const ISize_t i = array_find(array, key);
+  return i != array->capacity &&
+         __atomic_load_n(&array->slots[i].value, __ATOMIC_ACQUIRE) != REMOVED;
+}
+
+// get an element of the table, Null if absent
+void *vfc_swisstable_get(vfc_swisstable_t table, ISize_t key) {
+  table_array_t *array = __atomic_load_n(&table->array, __ATOMIC_ACQUIRE);
+  const ISize_t i = array_find(array, key);
+  if (i == array->capacity) {
+    return Null;
+  }
+  void *value = __atomic_load_n(&array->slots[i].value, __ATOMIC_ACQUIRE);
+  return value == REMOVED ? Null : value;
+}
+
+// get the number of elements in the table
+ISize_t vfc_swisstable_num_items(vfc_swisstable_t table) {
+  return __atomic_load_n(&table->nitems, __ATOMIC_RELAXED);
+}
+
+// iterate over the elements of the table
+IBool vfc_swisstable_next(vfc_swisstable_t table, ISize_t *cursor,
+                          ISize_t *key, void **value) {
+  table_array_t *array = __atomic_load_n(&table->array, __ATOMIC_ACQUIRE);
+  for (ISize_t i = *cursor; i < array->capacity; i++) {
+    if (IS_FULL(load_ctrl(array, i))) {
+      void *v = __atomic_load_n(&array->slots[i].value, __ATOMIC_ACQUIRE);
+      if (v == REMOVED) {
+        continue;
+      }
+      if (key) {
+        *key = array->slots[i].key;
+      }
+      if (value) {
+        *value = v;
+      }
+      *cursor = i + 1;
+      return ITrue;
+    }
+  }
+  *cursor = array->capacity;
+  return IFalse;
+}
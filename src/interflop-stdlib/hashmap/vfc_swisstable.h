@@ -0,0 +1,71 @@
+/*****************************************************************************\
+ *                                                                           *\
+ *  This file is part of the Verificarlo project,                            *\
+ *  under the Apache License v2.0 with LLVM Exceptions.                      *\
+ *  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 *\
+ *  See https://llvm.org/LICENSE.txt for license information.                *\
+ *                                                                           *\
+ *  Copyright (c) 2019-2026                                                  *\
+ *     Verificarlo Contributors                                              *\
+ *                                                                           *\
+ ****************************************************************************/
+
+#ifndef __VFC_SWISSTABLE_H__
+#define __VFC_SWISSTABLE_H__
+
+#define __VFC_SWISSTABLE_HEADER__
+
+#include "interflop/interflop_stdlib.h"
+
+/* Concurrent open-addressing table mapping ISize_t keys to pointers.
+ *
+ * Slots are organized in groups of 16 with one metadata byte per slot
+ * holding 7 bits of the key hash, so that a group is probed with a single
+ * SIMD comparison. Lookups are lock-free. Insertions and removals are
+ * lock-free as well, except while the table is being grown, during which
+ * writers wait for the new table to be published. Every key and value is
+ * valid, there are no reserved sentinels.
+ *
+ * Since readers take no lock, the tables replaced by a growth are only freed
+ * by vfc_swisstable_destroy. Without removals each one is at least twice as
+ * large as the previous one, so they take less memory than the current one;
+ * removed slots are only reclaimed by a growth, so a table with many
+ * removals may keep several tables of the same size. */
+typedef struct vfc_swisstable_st *vfc_swisstable_t;
+
+// allocate and initialize the table
+vfc_swisstable_t vfc_swisstable_create(void);
+
+// free the table, the values are not freed
+void vfc_swisstable_destroy(vfc_swisstable_t table);
+
+// insert or replace an element: returns Null if the key was absent, and the
+// replaced value otherwise (unlike vfc_swisstable_insert_if_absent)
+void *vfc_swisstable_insert(vfc_swisstable_t table, ISize_t key, void *value);
+
+// insert an element if the key is absent: returns the value in the table,
+// that is value if the key was absent and the existing value otherwise
+void *vfc_swisstable_insert_if_absent(vfc_swisstable_t table, ISize_t key,
+                                      void *value);
+
+// remove an element, returns the removed value or Null
+void *vfc_swisstable_remove(vfc_swisstable_t table, ISize_t key);
+
+// test if an element is in the table
+IBool vfc_swisstable_have(vfc_swisstable_t table, ISize_t key);
+
+// get an element of the table, Null if absent
+void *vfc_swisstable_get(vfc_swisstable_t table, ISize_t key);
+
+// get the number of elements in the table
+ISize_t vfc_swisstable_num_items(vfc_swisstable_t table);
+
+// iterate over the elements: cursor must be initialized to 0, returns ITrue
+// and fills key and value (if not Null) while elements remain
+IBool vfc_swisstable_next(vfc_swisstable_t table, ISize_t *cursor,
+                          ISize_t *key, void **value);
+
+// 64-bit mixer used to hash keys
+IUint64_t vfc_swisstable_mix64(IUint64_t x);
+
+#endif /* __VFC_SWISSTABLE_H__ */
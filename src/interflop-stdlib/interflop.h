@@ -90,6 +90,9 @@ typedef struct interflop_function_info {
   short useFloat;
   // Indicate if the function use float
   short useDouble;
+  // Dense identifier of the function assigned by the frontend from an
+  // interned-string table, 0 when the frontend does not assign identifiers
+  ISize_t uid;
 } interflop_function_info_t;
 
 /* Verificarlo call stack */
@@ -130,6 +133,31 @@ struct interflop_backend_interface_t {
   /* interflop_finalize: called at the end of the instrumented program
    * execution */
   void (*interflop_finalize)(void *context);
+
+  /* Optional vector hooks: apply the operation to size contiguous lanes of
+   * a and b and store the results in c. When NULL, the frontend falls back
+   * to the scalar hooks lane by lane. */
+  void (*interflop_add_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_sub_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_mul_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+  void (*interflop_div_float_vector)(int size, const float *a, const float *b,
+                                     float *c, void *context);
+
+  void (*interflop_add_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
+  void (*interflop_sub_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
+  void (*interflop_mul_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
+  void (*interflop_div_double_vector)(int size, const double *a,
+                                      const double *b, double *c,
+                                      void *context);
 };
 
 /**
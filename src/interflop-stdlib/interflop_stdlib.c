@@ -76,6 +76,9 @@ interflop_debug_print_op_t interflop_debug_print_op = Null;
 interflop_gettimeofday_t interflop_gettimeofday = Null;
 interflop_register_printf_specifier_t interflop_register_printf_specifier =
     Null;
+interflop_vsnprintf_t interflop_vsnprintf = Null;
+interflop_write_t interflop_write = Null;
+interflop_fileno_t interflop_fileno = Null;
 
 void interflop_set_handler(const char *name, void *function_ptr) {
   if (name == Null) {
@@ -112,6 +115,9 @@ void interflop_set_handler(const char *name, void *function_ptr) {
   SET_HANDLER(debug_print_op)
   SET_HANDLER(gettimeofday)
   SET_HANDLER(register_printf_specifier)
+  SET_HANDLER(vsnprintf)
+  SET_HANDLER(write)
+  SET_HANDLER(fileno)
 }
 
 #include "common/float_const.h"
@@ -98,6 +98,12 @@ typedef int (*interflop_gettimeofday_t)(Itimeval_t *tv, Itimezone_t *tz);
 
 typedef int (*interflop_register_printf_specifier_t)(int __spec, void *__func,
                                                      void *__arginfo);
+typedef int (*interflop_vsnprintf_t)(char *str, ISize_t size,
+                                     const char *format, va_list ap);
+/* Do not follow libc API, returns the number of bytes written or -1 */
+/* Interrupted writes must be retried by the handler */
+typedef IInt64_t (*interflop_write_t)(int fd, const void *buf, ISize_t count);
+typedef int (*interflop_fileno_t)(File *stream);
 
 extern interflop_malloc_t interflop_malloc;
 extern interflop_fopen_t interflop_fopen;
@@ -131,6 +137,9 @@ extern interflop_debug_print_op_t interflop_debug_print_op;
 extern interflop_gettimeofday_t interflop_gettimeofday;
 extern interflop_register_printf_specifier_t
     interflop_register_printf_specifier;
+extern interflop_vsnprintf_t interflop_vsnprintf;
+extern interflop_write_t interflop_write;
+extern interflop_fileno_t interflop_fileno;
 
 float fpow2i(int i);
 double pow2i(int i);
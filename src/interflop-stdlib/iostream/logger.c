@@ -23,6 +23,17 @@
 
 #include "logger.h"
 
+/* The buffered mode gives each thread its own buffer, flushed when the thread
+ * exits. Without LOGGER_THREAD_SAFE (libinterflop_logger_no-tls, for the
+ * backends without TLS), the threads share one buffer and must not log
+ * concurrently in this mode. */
+#ifdef LOGGER_THREAD_SAFE
+#include <pthread.h>
+#define LOGGER_TLS __thread
+#else
+#define LOGGER_TLS
+#endif
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -117,12 +128,72 @@ static const char vfc_backends_logfile[] = "VFC_BACKENDS_LOGFILE";
 /* Environment variable for enabling/disabling the color */
 static const char vfc_backends_colored_logger[] = "VFC_BACKENDS_COLORED_LOGGER";
 
+/* Environment variable for enabling/disabling the per-thread buffers */
+static const char vfc_backends_logger_buffered[] =
+    "VFC_BACKENDS_LOGGER_BUFFERED";
+
+/* Environment variable for specifying the File shared by all the messages
+ * in buffered mode */
+static const char vfc_backends_logger_sink[] = "VFC_BACKENDS_LOGGER_SINK";
+
+/* Environment variable for limiting the number of messages displayed for
+ * each format string */
+static const char vfc_backends_logger_rate_limit[] =
+    "VFC_BACKENDS_LOGGER_RATE_LIMIT";
+
 static IBool logger_enabled = ITrue;
 static IBool logger_colored = IFalse;
 static File *logger_logfile = Null;
 static File *logger_stderr = Null;
 static int logger_level = logger_level_info;
 
+/* Buffered mode: each thread formats its messages in its own buffer and
+ * writes complete lines with a single write, so lines from different
+ * threads never interleave and threads do not contend on stdio locks.
+ * Messages longer than the buffer are formatted in a larger heap buffer,
+ * kept by the thread. */
+#define LOGGER_BUFFER_SIZE 4096
+
+typedef struct {
+  int fd;
+  /* the buffer is flushed when its thread exits */
+  IBool registered;
+  ISize_t length;
+  /* heap buffer of size bytes replacing storage, or Null */
+  char *data;
+  ISize_t size;
+  char storage[LOGGER_BUFFER_SIZE];
+} logger_buffer_t;
+
+static LOGGER_TLS logger_buffer_t logger_buffer = {.fd = -1, .length = 0};
+
+/* Panic handler given to logger_init, called once the buffer is flushed */
+static interflop_panic_t logger_panic = Null;
+
+static IBool logger_buffered = IFalse;
+/* Sink shared by the backends, opened by the first logger_init only */
+static File *logger_sink = Null;
+static int logger_logfile_fd = -1;
+static int logger_stderr_fd = -1;
+
+/* Rate limiting: number of messages displayed per format string, counted
+ * in a fixed-size table indexed by the address of the format */
+#define LOGGER_RATE_SLOTS 1024
+
+typedef struct {
+  const char *fmt;
+  ISize_t count;
+} logger_rate_slot_t;
+
+static logger_rate_slot_t logger_rate_slots[LOGGER_RATE_SLOTS];
+static long logger_rate_limit = 0;
+
+typedef enum {
+  logger_rate_display,
+  logger_rate_last, /* last message displayed for this format */
+  logger_rate_suppress
+} logger_rate_t;
+
 /* Returns ITrue if the logger is enabled */
 IBool is_logger_enabled(void) {
   const char *is_logger_enabled_env = interflop_getenv(vfc_backends_logger);
@@ -148,6 +219,34 @@ IBool is_logger_colored(void) {
   }
 }
 
+/* Returns ITrue if the per-thread buffers are enabled */
+IBool is_logger_buffered(void) {
+  const char *is_logger_buffered_env =
+      interflop_getenv(vfc_backends_logger_buffered);
+  if (is_logger_buffered_env == Null) {
+    return IFalse;
+  } else if (interflop_strcasecmp(is_logger_buffered_env, "True") == 0) {
+    return ITrue;
+  } else {
+    return IFalse;
+  }
+}
+
+/* Returns the maximal number of messages per format string, 0 if unlimited */
+long get_logger_rate_limit(void) {
+  const char *rate_limit_env = interflop_getenv(vfc_backends_logger_rate_limit);
+  if (rate_limit_env == Null || interflop_strtol == Null) {
+    return 0;
+  }
+  int error = 0;
+  char *endptr;
+  long rate_limit = interflop_strtol(rate_limit_env, &endptr, &error);
+  if (error != 0 || *endptr != '\0' || rate_limit < 0) {
+    return 0;
+  }
+  return rate_limit;
+}
+
 logger_level_t get_logger_level(void) {
   const char *logger_level_env = interflop_getenv(vfc_backends_logger_level);
   if (logger_level_env == Null) {
@@ -203,6 +302,264 @@ void set_logger_logfile() {
   }
 }
 
+/* Counts one more message with this format and tells if it is displayed */
+static logger_rate_t logger_rate_check(const char *fmt) {
+  if (logger_rate_limit == 0) {
+    return logger_rate_display;
+  }
+
+  const ISize_t mask = LOGGER_RATE_SLOTS - 1;
+  const ISize_t start = ((ISize_t)fmt >> 3) * 0x9E3779B97F4A7C15UL >> 54;
+  for (ISize_t i = 0; i < LOGGER_RATE_SLOTS; i++) {
+    logger_rate_slot_t *slot = &logger_rate_slots[(start + i) & mask];
+    const char *current = __atomic_load_n(&slot->fmt, __ATOMIC_ACQUIRE);
+    /* on failure, current holds the format stored by another thread */
+    if (current == Null &&
+        __atomic_compare_exchange_n(&slot->fmt, &current, fmt, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      current = fmt;
+    }
+    if (current != fmt) {
+      continue;
+    }
+    const ISize_t count = __atomic_add_fetch(&slot->count, 1, __ATOMIC_RELAXED);
+    if (count < (ISize_t)logger_rate_limit) {
+      return logger_rate_display;
+    } else if (count == (ISize_t)logger_rate_limit) {
+      return logger_rate_last;
+    } else {
+      return logger_rate_suppress;
+    }
+  }
+
+  /* the table is full, do not limit */
+  return logger_rate_display;
+}
+
+static inline char *logger_buffer_data(logger_buffer_t *buffer) {
+  return buffer->data != Null ? buffer->data : buffer->storage;
+}
+
+static inline ISize_t logger_buffer_size(const logger_buffer_t *buffer) {
+  return buffer->data != Null ? buffer->size : LOGGER_BUFFER_SIZE;
+}
+
+/* Writes the complete lines of the buffer, or all of it if partial is set */
+static void logger_buffer_flush(logger_buffer_t *buffer, IBool partial) {
+  char *data = logger_buffer_data(buffer);
+  ISize_t end = buffer->length;
+  if (!partial) {
+    while (end > 0 && data[end - 1] != '\n') {
+      end--;
+    }
+  }
+
+  ISize_t written = 0;
+  while (written < end) {
+    const IInt64_t r = interflop_write(buffer->fd, data + written, end - written);
+    if (r <= 0) {
+      /* the sink is broken, drop the message */
+      written = end;
+      break;
+    }
+    written += r;
+  }
+
+  for (ISize_t i = written; i < buffer->length; i++) {
+    data[i - written] = data[i];
+  }
+  buffer->length -= written;
+}
+
+/* Replaces the storage of the buffer by a heap buffer of at least size
+ * bytes, returns IFalse if it cannot be allocated */
+static IBool logger_buffer_grow(logger_buffer_t *buffer, ISize_t size) {
+  if (interflop_malloc == Null || interflop_free == Null) {
+    return IFalse;
+  }
+  ISize_t new_size = logger_buffer_size(buffer);
+  while (new_size < size) {
+    new_size *= 2;
+  }
+  char *data = (char *)interflop_malloc(new_size);
+  if (data == Null) {
+    return IFalse;
+  }
+  const char *old = logger_buffer_data(buffer);
+  for (ISize_t i = 0; i < buffer->length; i++) {
+    data[i] = old[i];
+  }
+  if (buffer->data != Null) {
+    interflop_free(buffer->data);
+  }
+  buffer->data = data;
+  buffer->size = new_size;
+  return ITrue;
+}
+
+/* Writes the rest of the buffer and releases its heap buffer */
+static void logger_buffer_close(logger_buffer_t *buffer) {
+  if (buffer->length > 0) {
+    logger_buffer_flush(buffer, ITrue);
+  }
+  if (buffer->data != Null) {
+    interflop_free(buffer->data);
+    buffer->data = Null;
+  }
+}
+
+#ifdef LOGGER_THREAD_SAFE
+static pthread_key_t logger_buffer_key;
+static pthread_once_t logger_buffer_once = PTHREAD_ONCE_INIT;
+
+static void logger_buffer_release(void *buffer) {
+  logger_buffer_close((logger_buffer_t *)buffer);
+}
+
+static void logger_buffer_key_create(void) {
+  pthread_key_create(&logger_buffer_key, logger_buffer_release);
+}
+#endif
+
+/* Returns the buffer of the calling thread */
+static logger_buffer_t *logger_thread_buffer(void) {
+  logger_buffer_t *buffer = &logger_buffer;
+#ifdef LOGGER_THREAD_SAFE
+  if (!buffer->registered) {
+    pthread_once(&logger_buffer_once, logger_buffer_key_create);
+    pthread_setspecific(logger_buffer_key, buffer);
+    buffer->registered = ITrue;
+  }
+#endif
+  return buffer;
+}
+
+/* The key destructors do not run for the thread calling exit */
+__attribute__((destructor)) static void logger_fini(void) {
+  if (logger_buffered) {
+    logger_buffer_close(&logger_buffer);
+  }
+}
+
+/* Flushes the messages of the calling thread before panicking */
+static void logger_flush_and_panic(const char *msg) {
+  if (logger_buffered) {
+    logger_buffer_close(&logger_buffer);
+  }
+  logger_panic(msg);
+}
+
+static void logger_buffer_vprintf(logger_buffer_t *buffer, const char *fmt,
+                                  va_list ap) {
+  va_list aq;
+  va_copy(aq, ap);
+  ISize_t space = logger_buffer_size(buffer) - buffer->length;
+  int n = interflop_vsnprintf(logger_buffer_data(buffer) + buffer->length,
+                              space, fmt, ap);
+  if (n >= 0 && (ISize_t)n >= space) {
+    /* grow the buffer so that the message is written at once, or else make
+     * room for it, and format it again */
+    if (!logger_buffer_grow(buffer, buffer->length + n + 1) &&
+        buffer->length > 0) {
+      logger_buffer_flush(buffer, ITrue);
+    }
+    space = logger_buffer_size(buffer) - buffer->length;
+    n = interflop_vsnprintf(logger_buffer_data(buffer) + buffer->length, space,
+                            fmt, aq);
+  }
+  va_end(aq);
+
+  if (n < 0) {
+    return;
+  } else if ((ISize_t)n >= space) {
+    /* the message is truncated, end its line so that the next messages do
+     * not continue it */
+    buffer->length = logger_buffer_size(buffer) - 1;
+    logger_buffer_data(buffer)[buffer->length - 1] = '\n';
+  } else {
+    buffer->length += n;
+  }
+}
+
+static void logger_buffer_printf(logger_buffer_t *buffer, const char *fmt,
+                                 ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  logger_buffer_vprintf(buffer, fmt, ap);
+  va_end(ap);
+}
+
+static void logger_buffered_header(logger_buffer_t *buffer,
+                                   const char *lvl_name,
+                                   const level_color lvl_color,
+                                   const IBool colored) {
+  if (colored) {
+    logger_buffer_printf(buffer, "%s%s%s [%s%s%s]: ", ansi_colors[lvl_color],
+                         lvl_name, ansi_colors[reset_color],
+                         ansi_colors[backend_color], backend_header,
+                         ansi_colors[reset_color]);
+  } else {
+    logger_buffer_printf(buffer, "%s [%s]: ", lvl_name, backend_header);
+  }
+}
+
+/* Formats the message in the buffer of the calling thread and writes the
+ * complete lines to fd. newline terminates the message with a new line. */
+static void logger_buffered_vprint(int fd, const char *lvl_name,
+                                   const level_color lvl_color,
+                                   const IBool newline, const char *fmt,
+                                   va_list ap) {
+  logger_buffer_t *buffer = logger_thread_buffer();
+  if (buffer->length > 0 && buffer->fd != fd) {
+    logger_buffer_flush(buffer, ITrue);
+  }
+  buffer->fd = fd;
+
+  logger_buffered_header(buffer, lvl_name, lvl_color, logger_colored);
+  logger_buffer_vprintf(buffer, fmt, ap);
+  if (newline) {
+    logger_buffer_printf(buffer, "\n");
+  }
+  logger_buffer_flush(buffer, IFalse);
+}
+
+static void logger_buffered_print(int fd, const char *lvl_name,
+                                  const level_color lvl_color,
+                                  const IBool newline, const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  logger_buffered_vprint(fd, lvl_name, lvl_color, newline, fmt, ap);
+  va_end(ap);
+}
+
+/* Enables the buffered mode if requested and supported by the frontend */
+void set_logger_buffered() {
+  if (!is_logger_buffered() || interflop_vsnprintf == Null ||
+      interflop_write == Null || interflop_fileno == Null) {
+    logger_buffered = IFalse;
+    return;
+  }
+
+  const char *logger_sink_env = interflop_getenv(vfc_backends_logger_sink);
+  if (logger_sink_env == Null) {
+    logger_logfile_fd = interflop_fileno(logger_logfile);
+    logger_stderr_fd = interflop_fileno(logger_stderr);
+  } else if (logger_sink == Null) {
+    /* Opened in append mode, so that the lines written by the different
+     * threads and processes sharing the sink never overlap */
+    int error = 0;
+    logger_sink = interflop_fopen(logger_sink_env, "a", &error);
+    if (logger_sink == Null) {
+      char *msg = interflop_strerror(error);
+      _interflop_err(EXIT_FAILURE, "Error [%s]: %s", backend_header, msg);
+    }
+    logger_logfile = logger_sink;
+    logger_logfile_fd = interflop_fileno(logger_sink);
+    logger_stderr_fd = logger_logfile_fd;
+  }
+  logger_buffered = ITrue;
+}
+
 static void logger_header(File *stream, const char *lvl_name,
                           const level_color lvl_color, const IBool colored) {
   if (colored) {
@@ -215,77 +572,123 @@ static void logger_header(File *stream, const char *lvl_name,
   }
 }
 
+/* Tells that the messages with the current format are suppressed */
+static void logger_rate_notice(File *stream, int fd, const char *lvl_name,
+                               const level_color lvl_color) {
+  static const char notice[] =
+      "rate limit of %ld messages reached, suppressing further messages "
+      "of this kind\n";
+  if (logger_buffered) {
+    logger_buffered_print(fd, lvl_name, lvl_color, IFalse, notice,
+                          logger_rate_limit);
+  } else {
+    logger_header(stream, lvl_name, lvl_color, logger_colored);
+    interflop_fprintf(stream, notice, logger_rate_limit);
+  }
+}
+
+/* Displays a debug or info message on stream */
+static void logger_vprint(File *stream, int fd, const char *lvl_name,
+                          const level_color lvl_color, const char *fmt,
+                          va_list argp) {
+  const logger_rate_t rate = logger_rate_check(fmt);
+  if (rate == logger_rate_suppress) {
+    return;
+  }
+
+  if (logger_buffered) {
+    logger_buffered_vprint(fd, lvl_name, lvl_color, IFalse, fmt, argp);
+  } else {
+    logger_header(stream, lvl_name, lvl_color, logger_colored);
+    interflop_vfprintf(stream, fmt, argp);
+  }
+
+  if (rate == logger_rate_last) {
+    logger_rate_notice(stream, fd, lvl_name, lvl_color);
+  }
+}
+
 /* Display the debug message */
 void logger_debug(const char *fmt, ...) {
-  if (logger_enabled && logger_level <= logger_level_debug) {
-    logger_header(logger_logfile, "Debug", debug_color, logger_colored);
-    va_list ap;
-    va_start(ap, fmt);
-    interflop_vfprintf(logger_logfile, fmt, ap);
-    va_end(ap);
-  }
+  va_list ap;
+  va_start(ap, fmt);
+  vlogger_debug(fmt, ap);
+  va_end(ap);
 }
 
 /* Display the info message */
 void logger_info(const char *fmt, ...) {
-  if (logger_enabled && logger_level <= logger_level_info) {
-    logger_header(logger_logfile, "Info", info_color, logger_colored);
-    va_list ap;
-    va_start(ap, fmt);
-    interflop_vfprintf(logger_logfile, fmt, ap);
-    va_end(ap);
-  }
+  va_list ap;
+  va_start(ap, fmt);
+  vlogger_info(fmt, ap);
+  va_end(ap);
 }
 
 /* Display the warning message */
 void logger_warning(const char *fmt, ...) {
-  if (logger_enabled && logger_level <= logger_level_warning) {
-    logger_header(logger_stderr, "Warning", warning_color, logger_colored);
-  }
   va_list ap;
   va_start(ap, fmt);
-  interflop_vwarnx(fmt, ap);
+  vlogger_warning(fmt, ap);
   va_end(ap);
 }
 
 /* Display the error message */
 void logger_error(const char *fmt, ...) {
-  if (logger_enabled && logger_level <= logger_level_error) {
-    logger_header(logger_stderr, "Error", error_color, logger_colored);
-  }
   va_list ap;
   va_start(ap, fmt);
-  _interflop_verrx(EXIT_FAILURE, fmt, ap);
+  vlogger_error(fmt, ap);
   va_end(ap);
 }
 
 /* Display the debug message */
 void vlogger_debug(const char *fmt, va_list argp) {
   if (logger_enabled && logger_level <= logger_level_debug) {
-    logger_header(logger_logfile, "Debug", debug_color, logger_colored);
-    interflop_vfprintf(logger_logfile, fmt, argp);
+    logger_vprint(logger_logfile, logger_logfile_fd, "Debug", debug_color, fmt,
+                  argp);
   }
 }
 
 /* Display the info message */
 void vlogger_info(const char *fmt, va_list argp) {
   if (logger_enabled && logger_level <= logger_level_info) {
-    logger_header(logger_logfile, "Info", info_color, logger_colored);
-    interflop_vfprintf(logger_logfile, fmt, argp);
+    logger_vprint(logger_logfile, logger_logfile_fd, "Info", info_color, fmt,
+                  argp);
   }
 }
 
 /* Display the warning message */
 void vlogger_warning(const char *fmt, va_list argp) {
-  if (logger_enabled && logger_level <= logger_level_warning) {
-    logger_header(logger_stderr, "Warning", warning_color, logger_colored);
+  const IBool displayed = logger_enabled && logger_level <= logger_level_warning;
+  const logger_rate_t rate = logger_rate_check(fmt);
+  if (rate == logger_rate_suppress) {
+    return;
+  }
+
+  if (displayed && logger_buffered) {
+    logger_buffered_vprint(logger_stderr_fd, "Warning", warning_color, ITrue,
+                           fmt, argp);
+  } else {
+    if (displayed) {
+      logger_header(logger_stderr, "Warning", warning_color, logger_colored);
+    }
+    interflop_vwarnx(fmt, argp);
+  }
+
+  if (displayed && rate == logger_rate_last) {
+    logger_rate_notice(logger_stderr, logger_stderr_fd, "Warning",
+                       warning_color);
   }
-  interflop_vwarnx(fmt, argp);
 }
 
 /* Display the error message */
 void vlogger_error(const char *fmt, va_list argp) {
-  if (logger_enabled && logger_level <= logger_level_error) {
+  const IBool displayed = logger_enabled && logger_level <= logger_level_error;
+  if (displayed && logger_buffered) {
+    logger_buffered_vprint(logger_stderr_fd, "Error", error_color, ITrue, fmt,
+                           argp);
+    interflop_exit(EXIT_FAILURE);
+  }
+  if (displayed) {
     logger_header(logger_stderr, "Error", error_color, logger_colored);
   }
   _interflop_verrx(EXIT_FAILURE, fmt, argp);
@@ -308,13 +711,17 @@ void logger_init(interflop_panic_t panic, File *stream,
                  const char *backend_header_name) {
   backend_header = backend_header_name;
   logger_stderr = stream;
-  interflop_set_handler("panic", (void *)panic);
+  logger_panic = panic;
+  interflop_set_handler("panic",
+                        panic ? (void *)logger_flush_and_panic : Null);
   _logger_check_stdlib();
 
   logger_enabled = is_logger_enabled();
   logger_colored = is_logger_colored();
   logger_level = get_logger_level();
+  logger_rate_limit = get_logger_rate_limit();
   set_logger_logfile();
+  set_logger_buffered();
 }
 
 #if defined(__cplusplus)
@@ -70,9 +70,26 @@ void _init_rng_state_struct(rng_state_t *rng_state, bool choose_seed,
     rng_state->choose_seed = choose_seed;
     rng_state->seed = seed;
     rng_state->random_state_valid = random_state_valid;
+    rng_state->random_vector_state_valid = false;
+    rng_state->skip_count_valid = false;
   }
 }
 
+/* Seeds the vector lanes from the scalar generator once it is initialized */
+#define _INIT_RANDOM_VECTOR_STATE(RANDOM_STATE, GLOBAL_TID)                    \
+  {                                                                            \
+    _INIT_RANDOM_STATE(RANDOM_STATE, GLOBAL_TID);                              \
+    if (RANDOM_STATE->random_vector_state_valid == false) {                    \
+      for (int i = 0; i < RNG_VECTOR_LANES; i++) {                             \
+        RANDOM_STATE->random_vector_state[0][i] =                              \
+            next(RANDOM_STATE->random_state);                                  \
+        RANDOM_STATE->random_vector_state[1][i] =                              \
+            next(RANDOM_STATE->random_state);                                  \
+      }                                                                        \
+      RANDOM_STATE->random_vector_state_valid = true;                          \
+    }                                                                          \
+  }
+
 /* Returns a 32-bit unsigned integer r (0 <= r < 2^32) */
 uint32_t get_rand_uint32(rng_state_t *rng_state, pid_t *global_tid) {
   _INIT_RANDOM_STATE(rng_state, global_tid);
@@ -94,3 +111,58 @@ double get_rand_double01(rng_state_t *rng_state, pid_t *global_tid) {
   _INIT_RANDOM_STATE(rng_state, global_tid);
   return next_double(rng_state->random_state);
 }
+
+/* Natural logarithm of a positive normal number, the library being libm-free */
+/* x = m * 2^e with sqrt(2)/2 <= m < sqrt(2), and log(m) = 2 atanh(s) with */
+/* s = (m - 1) / (m + 1), |s| < 0.172, whose series converges quickly */
+static double _log(double x) {
+  union {
+    double d;
+    uint64_t u;
+  } v = {.d = x};
+  int e = (int)((v.u >> 52) & 0x7ff) - 1023;
+  v.u = (v.u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  double m = v.d;
+  if (m > 0x1.6a09e667f3bcdp+0) {
+    m *= 0.5;
+    e++;
+  }
+  const double s = (m - 1.0) / (m + 1.0);
+  const double s2 = s * s;
+  double term = s, sum = 0.0;
+  for (int k = 1; k < 24; k += 2) {
+    sum += term / k;
+    term *= s2;
+  }
+  return 2.0 * sum + e * 0x1.62e42fefa39efp-1;
+}
+
+/* Returns a geometric random variable of parameter p, by inversion */
+uint64_t get_rand_geometric(rng_state_t *rng_state, pid_t *global_tid,
+                            double p) {
+  if (p >= 1.0) {
+    return 0;
+  }
+  const double u = get_rand_double01(rng_state, global_tid);
+  /* log(1 - p) = -p - p^2/2 - ..., 1 - p rounds to 1 for tiny p */
+  const double log_q = (p < 0x1p-26) ? -p : _log(1.0 - p);
+  const double r = _log(u) / log_q;
+  return (r < 0x1p64) ? (uint64_t)r : UINT64_MAX;
+}
+
+/* Fills result with n 64-bit unsigned integers r (0 <= r < 2^64) */
+void get_rand_uint64_vector(rng_state_t *rng_state, pid_t *global_tid,
+                            uint64_t *result, int n) {
+  _INIT_RANDOM_VECTOR_STATE(rng_state, global_tid);
+  int i = 0;
+  for (; i + RNG_VECTOR_LANES <= n; i += RNG_VECTOR_LANES) {
+    next_vector(rng_state->random_vector_state, &result[i]);
+  }
+  if (i < n) {
+    uint64_t tail[RNG_VECTOR_LANES];
+    next_vector(rng_state->random_vector_state, tail);
+    for (int j = 0; i < n; i++, j++) {
+      result[i] = tail[j];
+    }
+  }
+}
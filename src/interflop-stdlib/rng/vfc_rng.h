@@ -22,6 +22,8 @@
 
 #include "xoroshiro128.h"
 #define __INTERNAL_RNG_STATE xoroshiro_state
+#define __INTERNAL_RNG_VECTOR_STATE xoroshiro_vector_state
+#define RNG_VECTOR_LANES XOROSHIRO_LANES
 
 /* Data type used to hold information required by the RNG */
 typedef struct rng_state {
@@ -29,6 +31,11 @@ typedef struct rng_state {
   uint64_t seed;
   bool random_state_valid;
   __INTERNAL_RNG_STATE random_state;
+  bool random_vector_state_valid;
+  __INTERNAL_RNG_VECTOR_STATE random_vector_state;
+  /* Operations left to skip before the next perturbed one (sparsity) */
+  bool skip_count_valid;
+  uint64_t skip_count;
 } rng_state_t;
 
 /* Get a new identifier for the calling thread */
@@ -69,4 +76,26 @@ uint32_t get_rand_uint32(rng_state_t *rng_state, pid_t *global_tid);
 /* @return a floating point number r (0.0 < r < 1.0) */
 double get_rand_double01(rng_state_t *rng_state, pid_t *global_tid);
 
+/* Returns the number of failures before the first success in a sequence of */
+/* independent Bernoulli trials of probability p (geometric distribution) */
+/* Draws a single random number whatever the result */
+/* Manages the internal state of the RNG, if necessary */
+/* @param rng_state pointer to the structure holding all the RNG-related data */
+/* @param global_tid pointer to the unique TID */
+/* @param p probability of success of a trial (0 < p <= 1) */
+/* @return the number of failures r (0 <= r <= UINT64_MAX) */
+uint64_t get_rand_geometric(rng_state_t *rng_state, pid_t *global_tid,
+                            double p);
+
+/* Fills an array with 64-bit unsigned integers r (0 <= r < 2^64) */
+/* Values are drawn RNG_VECTOR_LANES at a time from independent streams */
+/* seeded from the scalar generator, so a fixed seed stays reproducible */
+/* Manages the internal state of the RNG, if necessary */
+/* @param rng_state pointer to the structure holding all the RNG-related data */
+/* @param global_tid pointer to the unique TID */
+/* @param result array receiving the random numbers */
+/* @param n number of random numbers to draw */
+void get_rand_uint64_vector(rng_state_t *rng_state, pid_t *global_tid,
+                            uint64_t *result, int n);
+
 #endif /* __VFC_RNG_H__ */
@@ -38,6 +38,20 @@ uint64_t next(xoroshiro_state s) {
   return result;
 }
 
+/* Advances the XOROSHIRO_LANES streams of state by one step and stores one
+ * output per lane in result */
+void next_vector(xoroshiro_vector_state s, uint64_t *result) {
+  for (int i = 0; i < XOROSHIRO_LANES; i++) {
+    const uint64_t s0 = s[0][i];
+    uint64_t s1 = s[1][i];
+    result[i] = rotl(s0 + s1, 17) + s0;
+
+    s1 ^= s0;
+    s[0][i] = rotl(s0, 49) ^ s1 ^ (s1 << 21); // a, b
+    s[1][i] = rotl(s1, 28);                   // c
+  }
+}
+
 /*
   Taken from https://prng.di.unimi.it/
   "The code above cooks up by bit manipulation a real number in the interval
@@ -17,7 +17,15 @@
 
 typedef uint64_t xoroshiro_state[2];
 
+/* Number of independent xoroshiro128++ streams advanced together by
+ * next_vector. The state is laid out as structure-of-arrays so that each
+ * step is a handful of lane-wise integer operations the compiler maps onto
+ * SIMD registers. */
+#define XOROSHIRO_LANES 8
+typedef uint64_t xoroshiro_vector_state[2][XOROSHIRO_LANES];
+
 uint64_t next(xoroshiro_state state);
 double next_double(xoroshiro_state state);
+void next_vector(xoroshiro_vector_state state, uint64_t *result);
 
 #endif /* __XOROSHIRO128_H__ */
@@ -16,6 +16,11 @@ function run() {
 
 run test_pow2
 run test_string_equal
+run test_swisstable
+run test_strintern
+run test_arena
+run test_logger
+run test_rng_geometric
 
 echo "All tests passed"
 exit 0
@@ -0,0 +1,64 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../interflop_stdlib.c"
+#include "../../hashmap/vfc_arena.c"
+
+#define NB_OBJECTS 100000
+#define NB_THREADS 8
+
+vfc_arena_t arena;
+
+/* every thread allocates objects of various sizes and fills them */
+void *allocate(void *arg) {
+  const unsigned char tag = (unsigned char)(size_t)arg;
+  unsigned char **objects = malloc(NB_OBJECTS * sizeof(unsigned char *));
+  for (size_t i = 0; i < NB_OBJECTS; i++) {
+    const size_t size = (i % 100 == 0) ? 20000 : i % 97;
+    objects[i] = vfc_arena_alloc(arena, size);
+    assert(((uintptr_t)objects[i] & 15) == 0);
+    for (size_t j = 0; j < size; j++) {
+      assert(objects[i][j] == 0);
+      objects[i][j] = tag;
+    }
+  }
+  /* no object was handed out twice */
+  for (size_t i = 0; i < NB_OBJECTS; i++) {
+    const size_t size = (i % 100 == 0) ? 20000 : i % 97;
+    for (size_t j = 0; j < size; j++) {
+      assert(objects[i][j] == tag);
+    }
+  }
+  free(objects);
+  return NULL;
+}
+
+int main() {
+  interflop_set_handler("malloc", malloc);
+  interflop_set_handler("calloc", calloc);
+  interflop_set_handler("free", free);
+
+  arena = vfc_arena_create();
+
+  pthread_t threads[NB_THREADS];
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_create(&threads[i], NULL, allocate, (void *)(i + 1));
+  }
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  const char *str = "function_name";
+  char *copy = vfc_arena_strdup(arena, str);
+  assert(copy != str && strcmp(copy, str) == 0);
+  assert(strcmp(vfc_arena_strdup(arena, ""), "") == 0);
+
+  vfc_arena_destroy(arena);
+
+  printf("ok\n");
+  return 0;
+}
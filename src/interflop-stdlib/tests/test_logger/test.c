@@ -0,0 +1,95 @@
+#include <errno.h>
+#include <err.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../interflop_stdlib.c"
+#include "../../iostream/logger.c"
+
+#define NB_THREADS 8
+/* longer than the logger buffers */
+#define LONG_SIZE 10000
+
+static File *_fopen(const char *path, const char *mode, int *error) {
+  FILE *f = fopen(path, mode);
+  if (f == NULL) {
+    *error = errno;
+  }
+  return (File *)f;
+}
+
+static int _fileno(File *stream) { return fileno((FILE *)stream); }
+
+static IInt64_t _write(int fd, const void *buf, ISize_t count) {
+  return write(fd, buf, count);
+}
+
+static int _gettid(void) { return getpid(); }
+
+/* exits without running the destructors, as an abort would */
+static void _panic(const char *msg) {
+  fprintf(stderr, "%s", msg);
+  _exit(3);
+}
+
+char long_message[LONG_SIZE + 1];
+
+/* messages of a single thread, the last one without a new line */
+void log_messages(void) {
+  logger_info("first message %d\n", 1);
+  logger_info("message in ");
+  logger_info("two parts\n");
+  logger_info("%s\n", long_message);
+  logger_info("last message without a new line");
+}
+
+/* every thread logs a long line, and a partial one written when it exits */
+void *log_thread(void *arg) {
+  const int id = (int)(size_t)arg;
+  char line[LONG_SIZE + 1];
+  memset(line, 'A' + id, LONG_SIZE);
+  line[LONG_SIZE] = '\0';
+  logger_info("%s\n", line);
+  logger_info("partial line of thread %d", id);
+  return NULL;
+}
+
+int main(int argc, char *argv[]) {
+  interflop_set_handler("malloc", malloc);
+  interflop_set_handler("free", free);
+  interflop_set_handler("fopen", _fopen);
+  interflop_set_handler("getenv", getenv);
+  interflop_set_handler("fprintf", fprintf);
+  interflop_set_handler("vfprintf", vfprintf);
+  interflop_set_handler("strcasecmp", strcasecmp);
+  interflop_set_handler("strerror", strerror);
+  interflop_set_handler("sprintf", sprintf);
+  interflop_set_handler("gettid", _gettid);
+  interflop_set_handler("vwarnx", vwarnx);
+  interflop_set_handler("exit", exit);
+  interflop_set_handler("vsnprintf", vsnprintf);
+  interflop_set_handler("write", _write);
+  interflop_set_handler("fileno", _fileno);
+
+  memset(long_message, 'x', LONG_SIZE);
+  logger_init(_panic, (File *)stderr, "test");
+
+  if (argc > 1 && strcmp(argv[1], "threads") == 0) {
+    pthread_t threads[NB_THREADS];
+    for (size_t i = 0; i < NB_THREADS; i++) {
+      pthread_create(&threads[i], NULL, log_thread, (void *)i);
+    }
+    for (size_t i = 0; i < NB_THREADS; i++) {
+      pthread_join(threads[i], NULL);
+    }
+  } else if (argc > 1 && strcmp(argv[1], "panic") == 0) {
+    logger_info("message before the panic");
+    interflop_panic("panic\n");
+  } else {
+    log_messages();
+  }
+  return 0;
+}
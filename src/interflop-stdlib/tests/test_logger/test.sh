@@ -0,0 +1,39 @@
+#!/bin/bash
+# Compares the output of the logger in stdio and buffered modes, and checks
+# that the buffered mode writes long lines at once and the partial lines of
+# the threads when they exit or panic
+
+set -e
+
+check() {
+    echo "$1"
+    gcc test.c -o test -D__INTERFLOP_BOOTSTRAP__ -I../.. -pthread -O2 $2
+
+    ./test 2>unbuffered
+    VFC_BACKENDS_LOGGER_BUFFERED=True ./test 2>buffered
+    cmp unbuffered buffered
+    tail -n 1 buffered | grep -qx "Info \[test\]: last message without a new line"
+
+    if [ "$3" = "threads" ]; then
+        rm -f sink
+        VFC_BACKENDS_LOGGER_BUFFERED=True VFC_BACKENDS_LOGGER_SINK=sink ./test threads
+        # Each long line is written at once, and each partial line at the exit
+        # of its thread
+        test "$(grep -o "[A-H]\+" sink | awk '{ print length($0) }' | uniq -c | xargs)" = "8 10000"
+        test "$(grep -o "[A-H]\+" sink | cut -c 1 | sort -u | wc -l)" = 8
+        for i in $(seq 0 7); do
+            grep -q "partial line of thread $i" sink
+        done
+    fi
+
+    if VFC_BACKENDS_LOGGER_BUFFERED=True ./test panic 2>panicked; then
+        echo "the panic should have exited"
+        exit 1
+    fi
+    grep -q "message before the panic" panicked
+}
+
+check "per-thread buffers" -DLOGGER_THREAD_SAFE threads
+check "single buffer" ""
+rm -f test unbuffered buffered sink panicked
+echo "Test passed"
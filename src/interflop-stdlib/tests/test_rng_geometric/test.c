@@ -0,0 +1,95 @@
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../interflop_stdlib.c"
+#include "../../rng/splitmix64.c"
+#include "../../rng/vfc_rng.c"
+#include "../../rng/xoroshiro128.c"
+#include "interflop/common/options.h"
+
+#define NB_DRAWS 200000
+
+static rng_state_t rng_state;
+static pid_t global_tid = 0;
+
+static void seed(uint64_t seed) {
+  rng_state.random_state_valid = false;
+  _init_rng_state_struct(&rng_state, true, seed, false);
+}
+
+/* The mean of NB_DRAWS values of variance var is within 5 standard */
+/* deviations of expected */
+static void check_mean(const char *what, double p, double mean,
+                       double expected, double var) {
+  const double tolerance = 5 * sqrt(var / NB_DRAWS);
+  if (fabs(mean - expected) > tolerance) {
+    fprintf(stderr, "%s, p=%a: mean %g, expected %g +- %g\n", what, p, mean,
+            expected, tolerance);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* One perturbed operation every 1/p operations: the skip count plus the */
+/* perturbed operation has mean 1/p and variance (1-p)/p^2 */
+static void check_geometric(double p) {
+  seed(42);
+  double sum = 0;
+  for (int i = 0; i < NB_DRAWS; i++) {
+    sum += (double)get_rand_geometric(&rng_state, &global_tid, p) + 1.0;
+  }
+  check_mean("get_rand_geometric", p, sum / NB_DRAWS, 1 / p,
+             (1 - p) / (p * p));
+}
+
+/* Each operation is perturbed with probability sparsity */
+static void check_skip_eval(float sparsity) {
+  seed(7);
+  long perturbed = 0;
+  for (int i = 0; i < NB_DRAWS; i++) {
+    perturbed += !_mca_skip_eval(sparsity, &rng_state, &global_tid);
+  }
+  check_mean("_mca_skip_eval", sparsity, (double)perturbed / NB_DRAWS,
+             sparsity, sparsity * (1 - sparsity));
+}
+
+int main() {
+
+  /* The libm-free logarithm is accurate over the range of 1 - p and of the */
+  /* uniform numbers */
+  for (double x = 0x1p-60; x < 1; x *= 1.01) {
+    assert(fabs(_log(x) - log(x)) <= 0x1p-50 * fabs(log(x)));
+  }
+  for (double x = 0.5; x < 1; x += 0x1p-12) {
+    assert(fabs(_log(x) - log(x)) <= 0x1p-50 * fabs(log(x)));
+  }
+
+  /* Sparsity 1.0 perturbs every operation, without drawing numbers */
+  seed(1);
+  for (int i = 0; i < 1000; i++) {
+    assert(get_rand_geometric(&rng_state, &global_tid, 1.0) == 0);
+    assert(_mca_skip_eval(1.0f, &rng_state, &global_tid) == false);
+  }
+  assert(rng_state.random_state_valid == false);
+
+  const double sparsities[] = {0.999, 0.9, 0.5, 0.1, 0.01, 1e-3};
+  for (size_t i = 0; i < sizeof(sparsities) / sizeof(*sparsities); i++) {
+    check_geometric(sparsities[i]);
+    check_skip_eval(sparsities[i]);
+  }
+
+  /* Near 0, on both sides of the first order approximation of log(1 - p) */
+  const double tiny[] = {0x1p-25, 0x1p-26, 0x1p-27, 1e-9, 1e-12, 1e-15};
+  for (size_t i = 0; i < sizeof(tiny) / sizeof(*tiny); i++) {
+    check_geometric(tiny[i]);
+  }
+
+  /* Skip counts beyond 2^64 saturate */
+  seed(3);
+  for (int i = 0; i < 1000; i++) {
+    assert(get_rand_geometric(&rng_state, &global_tid, 1e-300) > (1ULL << 63));
+  }
+
+  fprintf(stderr, "Test passed\n");
+}
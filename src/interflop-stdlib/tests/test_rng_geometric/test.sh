@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# common/options.h includes the headers of the installed library
+mkdir -p include
+ln -sfn ../../.. include/interflop
+
+echo "-O0"
+gcc test.c -o test -I../.. -Iinclude -pthread -O0 -lm
+./test
+
+echo "-O3"
+gcc test.c -o test -I../.. -Iinclude -pthread -O3 -lm
+./test
@@ -0,0 +1,74 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../interflop_stdlib.c"
+#include "../../hashmap/vfc_strintern.c"
+#include "../../hashmap/vfc_swisstable.c"
+
+#define NB_STRINGS 20000
+#define NB_THREADS 8
+
+vfc_strintern_t table;
+
+/* every thread interns all the strings in a different order */
+void *intern_strings(void *arg) {
+  const size_t offset = (size_t)arg;
+  char str[32];
+  for (size_t i = 0; i < NB_STRINGS; i++) {
+    const size_t n = (i * 2654435761UL + offset) % NB_STRINGS;
+    sprintf(str, "function_%zu", n);
+    const size_t id = vfc_strintern_id(table, str);
+    assert(id < NB_STRINGS);
+    assert(vfc_strintern_lookup(table, str) == id);
+    assert(strcmp(vfc_strintern_str(table, id), str) == 0);
+  }
+  return NULL;
+}
+
+int main() {
+  interflop_set_handler("malloc", malloc);
+  interflop_set_handler("calloc", calloc);
+  interflop_set_handler("free", free);
+
+  table = vfc_strintern_create();
+
+  assert(vfc_strintern_lookup(table, "function_0") == VFC_STRINTERN_NONE);
+  assert(vfc_strintern_str(table, 0) == NULL);
+
+  pthread_t threads[NB_THREADS];
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_create(&threads[i], NULL, intern_strings, (void *)(i * 7919));
+  }
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  /* IDs are dense and every string was interned once */
+  assert(vfc_strintern_num_strings(table) == NB_STRINGS);
+  char *seen = calloc(NB_STRINGS, 1);
+  char str[32];
+  for (size_t n = 0; n < NB_STRINGS; n++) {
+    sprintf(str, "function_%zu", n);
+    const size_t id = vfc_strintern_lookup(table, str);
+    assert(id < NB_STRINGS);
+    assert(!seen[id]);
+    seen[id] = 1;
+  }
+  free(seen);
+
+  /* prefixes and the empty string are distinct strings */
+  const size_t empty = vfc_strintern_id(table, "");
+  const size_t prefix = vfc_strintern_id(table, "function_");
+  assert(empty == NB_STRINGS && prefix == NB_STRINGS + 1);
+  assert(vfc_strintern_id(table, "") == empty);
+  assert(strcmp(vfc_strintern_str(table, empty), "") == 0);
+  assert(vfc_strintern_lookup(table, "function_1x") == VFC_STRINTERN_NONE);
+
+  vfc_strintern_destroy(table);
+
+  printf("ok\n");
+  return 0;
+}
@@ -0,0 +1,146 @@
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../interflop_stdlib.c"
+#include "../../hashmap/vfc_swisstable.c"
+
+#define NB_KEYS 100000
+#define NB_THREADS 8
+
+vfc_swisstable_t table;
+
+/* value associated to a key, 0 is a valid key */
+#define VALUE(KEY) ((void *)((KEY)*3 + 1))
+
+/* every thread inserts all the keys in a different order */
+void *insert_keys(void *arg) {
+  const size_t offset = (size_t)arg;
+  for (size_t i = 0; i < NB_KEYS; i++) {
+    const size_t key = (i * 2654435761UL + offset) % NB_KEYS;
+    void *value = vfc_swisstable_insert_if_absent(table, key, VALUE(key));
+    assert(value == VALUE(key));
+    assert(vfc_swisstable_get(table, key) == VALUE(key));
+  }
+  return NULL;
+}
+
+/* replacements and removals racing on a few keys: every value inserted must
+ * come out exactly once, returned by a replacement or a removal, or left in
+ * the table */
+#define NB_RACE_KEYS 4
+#define NB_RACE_OPS 200000
+
+/* values are indices in owned, plus one so that Null stays unused */
+unsigned char owned[NB_THREADS * NB_RACE_OPS + 1];
+
+void release(void *value) {
+  if (value != NULL) {
+    const size_t v = (size_t)value;
+    assert(v <= NB_THREADS * NB_RACE_OPS);
+    assert(__atomic_fetch_add(&owned[v], 1, __ATOMIC_RELAXED) == 0);
+  }
+}
+
+void *replace_remove_keys(void *arg) {
+  const size_t id = (size_t)arg;
+  for (size_t i = 0; i < NB_RACE_OPS; i++) {
+    const size_t key = (i + id) % NB_RACE_KEYS;
+    if (id % 2 == 0) {
+      void *value = (void *)(id * NB_RACE_OPS + i + 1);
+      release(vfc_swisstable_insert(table, key, value));
+    } else {
+      /* removers insert values as well, which the others may replace */
+      release(vfc_swisstable_remove(table, key));
+      if (i % 3 == 0) {
+        void *value = (void *)(id * NB_RACE_OPS + i + 1);
+        release(vfc_swisstable_insert(table, key, value));
+      }
+    }
+  }
+  return NULL;
+}
+
+void check_replace_remove(void) {
+  table = vfc_swisstable_create();
+
+  pthread_t threads[NB_THREADS];
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_create(&threads[i], NULL, replace_remove_keys, (void *)i);
+  }
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  size_t nb_items = 0;
+  for (size_t key = 0; key < NB_RACE_KEYS; key++) {
+    if (vfc_swisstable_have(table, key)) {
+      release(vfc_swisstable_remove(table, key));
+      nb_items++;
+    }
+  }
+  assert(vfc_swisstable_num_items(table) == 0);
+
+  /* the values that were inserted are exactly the ones released */
+  for (size_t id = 0; id < NB_THREADS; id++) {
+    for (size_t i = 0; i < NB_RACE_OPS; i++) {
+      const IBool inserted = id % 2 == 0 || i % 3 == 0;
+      assert(owned[id * NB_RACE_OPS + i + 1] == inserted);
+    }
+  }
+  assert(nb_items <= NB_RACE_KEYS);
+
+  vfc_swisstable_destroy(table);
+}
+
+int main() {
+  interflop_set_handler("malloc", malloc);
+  interflop_set_handler("calloc", calloc);
+  interflop_set_handler("free", free);
+
+  table = vfc_swisstable_create();
+
+  pthread_t threads[NB_THREADS];
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_create(&threads[i], NULL, insert_keys, (void *)(i * 7919));
+  }
+  for (size_t i = 0; i < NB_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  /* each key must be present exactly once */
+  assert(vfc_swisstable_num_items(table) == NB_KEYS);
+  char *seen = calloc(NB_KEYS, 1);
+  size_t cursor = 0, key, nb_items = 0;
+  void *value;
+  while (vfc_swisstable_next(table, &cursor, &key, &value)) {
+    assert(key < NB_KEYS && !seen[key]);
+    assert(value == VALUE(key));
+    seen[key] = 1;
+    nb_items++;
+  }
+  assert(nb_items == NB_KEYS);
+
+  /* remove odd keys then replace even values */
+  for (size_t i = 1; i < NB_KEYS; i += 2) {
+    assert(vfc_swisstable_remove(table, i) == VALUE(i));
+  }
+  assert(vfc_swisstable_num_items(table) == NB_KEYS / 2);
+  for (size_t i = 0; i < NB_KEYS; i++) {
+    assert(vfc_swisstable_have(table, i) == (i % 2 == 0));
+  }
+  for (size_t i = 0; i < NB_KEYS; i += 2) {
+    assert(vfc_swisstable_insert(table, i, NULL) == VALUE(i));
+    assert(vfc_swisstable_have(table, i));
+    assert(vfc_swisstable_get(table, i) == NULL);
+  }
+
+  vfc_swisstable_destroy(table);
+  free(seen);
+
+  check_replace_remove();
+
+  printf("Test passed\n");
+  return 0;
+}
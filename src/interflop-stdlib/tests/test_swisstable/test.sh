@@ -0,0 +1,13 @@
+#!/bin/bash
+
+echo "-O0"
+gcc test.c -o test -I../.. -pthread -O0
+./test
+
+echo "-O3"
+gcc test.c -o test -I../.. -pthread -O3
+./test
+
+echo "-O3 -mno-sse2"
+gcc test.c -o test -I../.. -pthread -O3 -mno-sse2
+./test
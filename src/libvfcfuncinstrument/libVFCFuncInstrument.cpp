@@ -652,5 +652,16 @@ extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
                   }
                   return false;
                 });
+            // in-process instrumentation (clang -fpass-plugin), on the
+            // optimized module as with the opt chain of the driver
+            PB.registerOptimizerLastEPCallback(
+#if LLVM_VERSION_MAJOR >= 20
+                [](ModulePassManager &MPM, OptimizationLevel,
+                   ThinOrFullLTOPhase) {
+#else
+                [](ModulePassManager &MPM, OptimizationLevel) {
+#endif
+                  MPM.addPass(VfclibFuncPass());
+                });
           }};
 }
@@ -20,6 +20,7 @@
 #include "../../config.h"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
@@ -42,6 +43,7 @@
 #include <cxxabi.h>
 #include <fstream>
 #include <functional>
+#include <map>
 #include <regex>
 #include <set>
 #include <sstream>
@@ -97,6 +99,37 @@ static cl::opt<bool> VfclibInstInstrumentCast(
     cl::desc("Instrument floating point cast instructions"),
     cl::value_desc("InstrumentCast"), cl::init(false));
 
+static cl::opt<bool> VfclibInstElideExact(
+    "vfclibinst-elide-exact",
+    cl::desc("Do not instrument operations that are exact in IEEE arithmetic"),
+    cl::value_desc("ElideExact"), cl::init(false));
+
+static cl::opt<bool> VfclibInstStats(
+    "vfclibinst-stats",
+    cl::desc("Report the number of instrumented and elided operations"),
+    cl::value_desc("Stats"), cl::init(false));
+
+static cl::opt<std::string> VfclibInstProfile(
+    "vfclibinst-profile",
+    cl::desc("Only instrument the source lines selected in file ProfileFile"),
+    cl::value_desc("ProfileFile"), cl::init(""));
+
+static cl::opt<unsigned> VfclibInstProfileTop(
+    "vfclibinst-profile-top",
+    cl::desc("Select the N hottest (or coldest) lines of the profile"),
+    cl::value_desc("N"), cl::init(0));
+
+static cl::opt<double> VfclibInstProfileCoverage(
+    "vfclibinst-profile-coverage",
+    cl::desc("Select the hottest (or coldest) lines of the profile that "
+             "account for Percent % of its counts"),
+    cl::value_desc("Percent"), cl::init(100.0));
+
+static cl::opt<bool> VfclibInstProfileCold(
+    "vfclibinst-profile-cold",
+    cl::desc("Select the coldest lines of the profile instead of the hottest"),
+    cl::value_desc("Cold"), cl::init(false));
+
 /* pointer that hold the vfcwrapper Module */
 static Module *vfcwrapperM = nullptr;
 
@@ -128,6 +161,14 @@ const std::set<unsigned> validVectorSizes = {2, 4, 8, 16};
 struct VfclibInst : public ModulePass {
   static char ID;
 
+  /* statistics reported with -vfclibinst-stats */
+  unsigned nbInstrumented = 0;
+  unsigned nbElided = 0;
+  unsigned nbUnselected = 0;
+
+  /* source lines selected in the profile, as (file name, line) -> path */
+  std::multimap<std::pair<std::string, unsigned>, std::string> profileLines;
+
   VfclibInst() : ModulePass(ID) {}
 
   // Taken from
@@ -249,6 +290,124 @@ struct VfclibInst : public ModulePass {
     return std::regex(moduleRegex);
   }
 
+  /* Parse the profile given with -vfclibinst-profile and select its lines.
+   * Each line of the profile is "<count> <file>:<line>[:<column>]", a file
+   * being either absolute or relative to any directory. The counts of a
+   * source line are summed, columns are ignored. */
+  void parseProfile() {
+    std::ifstream profile(VfclibInstProfile.c_str());
+    if (!profile.is_open()) {
+      errs() << "Cannot open " << VfclibInstProfile << "\n";
+      report_fatal_error("libVFCInstrument fatal error");
+    }
+
+    std::map<std::pair<std::string, unsigned>, uint64_t> counts;
+    int lineno = 0;
+    std::string line;
+    while (std::getline(profile, line)) {
+      lineno++;
+      StringRef l = StringRef(line).trim();
+
+      // Ignore empty or commented lines
+      if (STARTS_WITH(l, "#") || l.empty()) {
+        continue;
+      }
+
+      std::pair<StringRef, StringRef> p = l.split(" ");
+      std::pair<StringRef, StringRef> loc = p.second.trim().rsplit(':');
+      std::pair<StringRef, StringRef> locNoColumn = loc.first.rsplit(':');
+      uint64_t count = 0;
+      unsigned sourceLine = 0, column = 0;
+      StringRef file;
+      if (not locNoColumn.second.empty() and
+          not locNoColumn.second.getAsInteger(10, sourceLine) and
+          not loc.second.getAsInteger(10, column)) {
+        file = locNoColumn.first;
+      } else if (not loc.second.getAsInteger(10, sourceLine)) {
+        file = loc.first;
+      }
+      // Source lines start at 1, 0 is the line of compiler generated code
+      if (p.first.getAsInteger(10, count) or file.empty() or sourceLine == 0) {
+        errs() << "Syntax error in profile file " << VfclibInstProfile << ":"
+               << lineno << "\n";
+        report_fatal_error("libVFCInstrument fatal error");
+      }
+      counts[std::make_pair(file.str(), sourceLine)] += count;
+    }
+    profile.close();
+
+    // Sort the lines from the hottest to the coldest, or the reverse
+    std::vector<std::pair<uint64_t, std::pair<std::string, unsigned>>> sorted;
+    uint64_t total = 0;
+    for (auto &entry : counts) {
+      sorted.push_back(std::make_pair(entry.second, entry.first));
+      total += entry.second;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto &a, const auto &b) {
+                       return VfclibInstProfileCold ? a.first < b.first
+                                                    : a.first > b.first;
+                     });
+
+    const double threshold = total * VfclibInstProfileCoverage / 100.0;
+    uint64_t covered = 0;
+    for (auto &entry : sorted) {
+      if (VfclibInstProfileTop != 0 and
+          profileLines.size() >= VfclibInstProfileTop) {
+        break;
+      }
+      if (VfclibInstProfileCoverage < 100.0 and covered >= threshold) {
+        break;
+      }
+      const std::string &path = entry.second.first;
+      profileLines.insert(std::make_pair(
+          std::make_pair(sys::path::filename(path).str(), entry.second.second),
+          path));
+      covered += entry.first;
+    }
+
+    if (VfclibInstVerbose) {
+      errs() << "Profile " << VfclibInstProfile << ": " << profileLines.size()
+             << " of " << counts.size() << " lines selected\n";
+    }
+  }
+
+  /* Check if one path is a suffix of the other, by whole components */
+  static bool matchPath(const std::string &a, const std::string &b) {
+    const std::string &longer = (a.size() >= b.size()) ? a : b;
+    const std::string &shorter = (a.size() >= b.size()) ? b : a;
+    const size_t start = longer.size() - shorter.size();
+    return longer.compare(start, std::string::npos, shorter) == 0 and
+           (start == 0 or longer[start - 1] == '/');
+  }
+
+  /* Check if the debug location of I is a line selected in the profile */
+  bool isSelectedByProfile(Instruction &I) {
+    const DILocation *loc = I.getDebugLoc().get();
+    if (loc == nullptr) {
+      return false;
+    }
+
+    std::string file = loc->getFilename().str();
+    auto range = profileLines.equal_range(
+        std::make_pair(sys::path::filename(file).str(), loc->getLine()));
+    if (range.first == range.second) {
+      return false;
+    }
+
+    if (sys::path::is_relative(file) and not loc->getDirectory().empty()) {
+      SmallString<256> path(loc->getDirectory());
+      sys::path::append(path, file);
+      file = path.str().str();
+    }
+    for (auto it = range.first; it != range.second; ++it) {
+      if (matchPath(it->second, file)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   /* Load vfcwrapper.ll Module */
   void loadVfcwrapperIR(Module &M) {
     SMDiagnostic err;
@@ -266,6 +425,10 @@ struct VfclibInst : public ModulePass {
 
     loadVfcwrapperIR(M);
 
+    if (not VfclibInstProfile.empty()) {
+      parseProfile();
+    }
+
     // Parse both included and excluded function set
     std::regex includeFunctionRgx =
         parseFunctionSetFile(M, VfclibInstIncludeFile);
@@ -307,6 +470,17 @@ struct VfclibInst : public ModulePass {
     for (auto F : functions) {
       modified |= runOnFunction(M, *F);
     }
+
+    if (VfclibInstStats) {
+      errs() << "vfclibinst: " << M.getSourceFileName() << ": "
+             << nbInstrumented << " operations instrumented, " << nbElided
+             << " exact operations elided";
+      if (not VfclibInstProfile.empty()) {
+        errs() << ", " << nbUnselected << " operations not selected by the "
+               << "profile";
+      }
+      errs() << "\n";
+    }
     // runOnModule must return true if the pass modifies the IR
     return modified;
   }
@@ -609,6 +783,46 @@ struct VfclibInst : public ModulePass {
     return false;
   }
 
+  /* Value of a floating-point constant operand, splat vectors included */
+  const APFloat *getConstantOperand(Value *V) {
+    Constant *C = dyn_cast<Constant>(V);
+    if (C == nullptr)
+      return nullptr;
+    if (C->getType()->isVectorTy())
+      C = C->getSplatValue();
+    ConstantFP *CFP = dyn_cast_or_null<ConstantFP>(C);
+    return CFP ? &CFP->getValueAPF() : nullptr;
+  }
+
+  /* Check if v is a normal power of two, +/-2^k */
+  bool isPowerOfTwo(const APFloat &v) {
+    if (not v.isFiniteNonZero() or v.isDenormal())
+      return false;
+    int exponent = 0;
+    APFloat mantissa = frexp(v, exponent, APFloat::rmNearestTiesToEven);
+    return mantissa.isExactlyValue(0.5) or mantissa.isExactlyValue(-0.5);
+  }
+
+  /* Check if the result of the operation is exact in IEEE arithmetic, barring
+   * overflows and underflows: adding or subtracting zero, negating with
+   * -0.0 - x, multiplying by zero or scaling by a power of two */
+  bool isExactOperation(Instruction &I, FPOps opCode) {
+    const APFloat *lhs = getConstantOperand(I.getOperand(0));
+    const APFloat *rhs = getConstantOperand(I.getOperand(1));
+    switch (opCode) {
+    case FOP_ADD:
+    case FOP_SUB:
+      return (lhs and lhs->isZero()) or (rhs and rhs->isZero());
+    case FOP_MUL:
+      return (lhs and (lhs->isZero() or isPowerOfTwo(*lhs))) or
+             (rhs and (rhs->isZero() or isPowerOfTwo(*rhs)));
+    case FOP_DIV:
+      return (lhs and lhs->isZero()) or (rhs and isPowerOfTwo(*rhs));
+    default:
+      return false;
+    }
+  }
+
   FPOps mustReplace(Instruction &I) {
     switch (I.getOpcode()) {
     case Instruction::FAdd:
@@ -654,6 +868,16 @@ struct VfclibInst : public ModulePass {
       FPOps opCode = mustReplace(I);
       if (opCode == FOP_IGNORE)
         continue;
+      if (VfclibInstElideExact and isExactOperation(I, opCode)) {
+        if (VfclibInstVerbose)
+          errs() << "Eliding exact" << I << '\n';
+        nbElided++;
+        continue;
+      }
+      if (not VfclibInstProfile.empty() and not isSelectedByProfile(I)) {
+        nbUnselected++;
+        continue;
+      }
       WorkList.insert(std::make_pair(&I, opCode));
     }
 
@@ -666,6 +890,7 @@ struct VfclibInst : public ModulePass {
       if (value != nullptr) {
         BasicBlock::iterator ii(I);
         ReplaceInstWithValue(ii, value);
+        nbInstrumented++;
       }
       modified = true;
     }
@@ -701,5 +926,16 @@ extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
                   }
                   return false;
                 });
+            // in-process instrumentation (clang -fpass-plugin), on the
+            // optimized module as with the opt chain of the driver
+            PB.registerOptimizerLastEPCallback(
+#if LLVM_VERSION_MAJOR >= 20
+                [](ModulePassManager &MPM, OptimizationLevel,
+                   ThinOrFullLTOPhase) {
+#else
+                [](ModulePassManager &MPM, OptimizationLevel) {
+#endif
+                  MPM.addPass(VfclibInstPass());
+                });
           }};
 }
@@ -299,6 +299,24 @@ getHighestSupportedISA_X86_64(const TargetFeatures &features) -> X86_64_ISA {
   return x86_64_NONE;
 }
 
+// Width in bits of the vector registers of an ISA, 0 if unknown
+inline auto getVectorRegisterBits_X86_64(X86_64_ISA isa) -> unsigned {
+  switch (isa) {
+  case x86_64_AVX512F:
+    return 512;
+  case x86_64_AVX2:
+  case x86_64_AVX:
+    return 256;
+  case x86_64_SSE4:
+  case x86_64_SSE3:
+  case x86_64_SSE2:
+  case x86_64_SSE:
+    return 128;
+  default:
+    return 0;
+  }
+}
+
 inline auto hasFeatures_X86_64(const Attribute &src,
                                const Attribute &target) -> bool {
   std::vector<std::string> features = {"avx512f", "avx2", "avx", "sse4.2",
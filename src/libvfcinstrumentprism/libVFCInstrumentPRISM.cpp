@@ -46,6 +46,7 @@
 #include <llvm/Support/CommandLine.h>
 #include <llvm/Support/ErrorHandling.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/TargetParser/SubtargetFeature.h>
 #if LLVM_VERSION_MAJOR >= 18
 #include <llvm/TargetParser/Host.h>
@@ -63,10 +64,15 @@
 #include <llvm/IR/Mangler.h>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
 #include <cmath>
 #include <cxxabi.h>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <set>
+#include <vector>
 
 #include "TargetFeatures.hpp"
 #include "libVFCInstrumentPRISMOptions.hpp"
@@ -207,8 +213,6 @@ auto isValidVectorSize(const unsigned &size) -> bool {
 
 using FPOps = fops::type;
 
-std::set<std::string> functionsToExclude;
-
 [[maybe_unused]] auto get_mangled_name(Function *F) -> std::string {
   // Create a Mangler
   llvm::Mangler Mang;
@@ -242,92 +246,212 @@ auto PassingModeNamespace(PrismPassingMode mode) -> std::string {
   prism_fatal_error("Invalid passing mode");
 }
 
-class IRModule {
+// Index of the functions of a PRISM library, from their short demangled name
+// (without parameters, e.g. prism::sr::scalar::dynamic::addf64) to their
+// mangled name.
+//
+// Demangling every function of the library is most of the cost of loading it,
+// so the index is built once and saved in the -vfclibinst-prism-index-dir
+// directory (the cache entry of the library, see the verificarlo driver), along
+// with the size and date of the library it was built from. Other compilations
+// map this file and look the names up by binary search. Without this
+// directory, or when it is not writable, the index is built in memory, so that
+// nothing is written next to the installed library. Indexes are shared by all
+// the modules of a process.
+class PrismNameIndex {
 public:
-  explicit IRModule(Module &M, const std::string &irFile) {
-    libModule = loadVfcwrapperIR(M, irFile);
-    // if ir is null, an error message has already been printed
-    if (libModule == nullptr) {
-      prism_fatal_error("fatal error while reading library IR: " + irFile);
+  static auto get(const std::string &irFile) -> const PrismNameIndex & {
+    static std::map<std::string, std::unique_ptr<PrismNameIndex>> indexes;
+    static std::mutex indexesMutex;
+    std::lock_guard<std::mutex> guard(indexesMutex);
+    auto &index = indexes[irFile];
+    if (index == nullptr) {
+      index.reset(new PrismNameIndex(irFile));
     }
-    getDemangledNames();
-  }
-
-  auto hasFunction(const std::string &name) -> bool {
-    return demangledShortNamesToMangled.find(name) !=
-           demangledShortNamesToMangled.end();
+    return *index;
   }
 
-  auto getFunction(const std::string &name) -> Function * {
-    if (not hasFunction(name)) {
-      return nullptr;
+  // mangled name of the function shortName, empty if not in the library
+  [[nodiscard]] auto lookup(StringRef shortName) const -> StringRef {
+    auto it = std::lower_bound(
+        shortNames.begin(), shortNames.end(), shortName,
+        [](const std::pair<StringRef, StringRef> &entry, StringRef name) {
+          return entry.first < name;
+        });
+    if (it == shortNames.end() or it->first != shortName) {
+      return "";
     }
-    return libModule->getFunction(demangledShortNamesToMangled[name]);
+    return it->second;
   }
 
-  auto copyFunction(Module *M, Function *F,
-                    const std::string &functionName) -> FUNCTION_CALLEE {
-    auto functionNameMangled = demangledShortNamesToMangled[functionName];
-
-    return M->getOrInsertFunction(functionNameMangled, F->getFunctionType(),
-                                  F->getAttributes());
+  [[nodiscard]] auto isLibraryFunction(StringRef mangledName) const -> bool {
+    return std::binary_search(mangledNames.begin(), mangledNames.end(),
+                              mangledName);
   }
 
-  void printDemangledNamesLibsSR() {
-    errs() << "Demangled names\n";
-    for (auto &p : demangledNamesToMangled) {
-      if (p.first.find("N_") == p.first.npos) {
-        errs() << p.first << " : " << p.second << "\n";
-      }
-      // errs() << p.first << " : " << p.second << "\n";
+private:
+  std::unique_ptr<MemoryBuffer> buffer;
+  // sorted by short name
+  std::vector<std::pair<StringRef, StringRef>> shortNames;
+  // every function defined by the library, sorted
+  std::vector<StringRef> mangledNames;
+
+  explicit PrismNameIndex(const std::string &irFile) {
+    const std::string header = getHeader(irFile);
+    SmallString<128> indexFile(VfclibInstPrismIndexDir);
+    sys::path::append(indexFile, sys::path::filename(irFile) + ".index");
+
+    if (VfclibInstPrismIndexDir.empty()) {
+      buffer = MemoryBuffer::getMemBufferCopy(build(irFile, header), indexFile);
+      parse();
+      return;
     }
+
+    auto mapped = MemoryBuffer::getFile(indexFile, /*IsText=*/false,
+                                        /*RequiresNullTerminator=*/false);
+    if (mapped and STARTS_WITH((*mapped)->getBuffer(), header)) {
+      buffer = std::move(*mapped);
+    } else {
+      std::string content = build(irFile, header);
+      save(indexFile.str().str(), content);
+      buffer = MemoryBuffer::getMemBufferCopy(content, indexFile);
+    }
+    parse();
   }
 
-  void printDemangledNamesLibsSRShort() {
-    errs() << "Short demangled names\n";
-    for (auto &p : demangledShortNamesToMangled) {
-      if (p.first.find("N_") == p.first.npos) {
-        errs() << p.first << " : " << p.second << "\n";
-      }
+  static auto getHeader(const std::string &irFile) -> std::string {
+    sys::fs::file_status status;
+    if (sys::fs::status(irFile, status)) {
+      prism_fatal_error("Cannot open " + irFile);
     }
+    return "VFCPRISMINDEX 1 " + std::to_string(status.getSize()) + " " +
+           std::to_string(
+               status.getLastModificationTime().time_since_epoch().count()) +
+           "\n";
   }
 
-private:
-  std::unique_ptr<Module> libModule = nullptr;
-  std::map<std::string, std::string> demangledNamesToMangled;
-  std::map<std::string, std::string> demangledShortNamesToMangled;
+  static auto build(const std::string &irFile,
+                    const std::string &header) -> std::string {
+    LLVMContext context;
+    SMDiagnostic err;
+    // only the function names are needed, not their bodies
+    auto lib = getLazyIRFileModule(irFile, err, context);
+    if (lib == nullptr) {
+      err.print(irFile.c_str(), errs());
+      prism_fatal_error("fatal error while reading library IR: " + irFile);
+    }
 
-  void getDemangledNames() {
-    for (auto &F : libModule->functions()) {
+    std::map<std::string, std::string> shortToMangled;
+    std::set<std::string> mangled;
+    for (auto &F : lib->functions()) {
       if (F.isDeclaration()) {
         continue;
       }
       const std::string &mangled_name = F.getName().str();
-      functionsToExclude.insert(mangled_name);
+      mangled.insert(mangled_name);
 
       std::string demangled_name = get_demangled_name(mangled_name);
-      demangledNamesToMangled[demangled_name] = mangled_name;
-
       size_t parenPos = demangled_name.find('(');
       std::string demangled_name_short =
           (parenPos != std::string::npos) ? demangled_name.substr(0, parenPos)
                                           : demangled_name;
 
-      demangledShortNamesToMangled[demangled_name_short] = mangled_name;
+      shortToMangled[demangled_name_short] = mangled_name;
+    }
+
+    std::string content = header;
+    for (auto &p : shortToMangled) {
+      content += p.first + "\t" + p.second + "\n";
+    }
+    content += "\n";
+    for (const auto &name : mangled) {
+      content += name + "\n";
     }
-    // printDemangledNamesLibsSRShort();
+    return content;
   }
 
-  /* Load vfcwrapper.ll Module */
-  static auto loadVfcwrapperIR(Module &M, const std::string &irFile)
-      -> std::unique_ptr<Module> {
-    SMDiagnostic err;
-    auto newM = parseIRFile(irFile, err, M.getContext());
-    if (newM == nullptr) {
-      err.print(irFile.c_str(), errs());
-      prism_fatal_error();
+  // write the index under a temporary name and rename it, so that concurrent
+  // compilations never map a partial index
+  static void save(const std::string &indexFile, const std::string &content) {
+    int fd = 0;
+    SmallString<128> tmpFile;
+    if (sys::fs::createUniqueFile(indexFile + ".%%%%%%", fd, tmpFile)) {
+      return;
+    }
+    raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << content;
+    os.close();
+    if (os.has_error() or sys::fs::rename(tmpFile, indexFile)) {
+      os.clear_error();
+      sys::fs::remove(tmpFile);
+    }
+  }
+
+  void parse() {
+    StringRef data = buffer->getBuffer().split('\n').second;
+    bool inShortNames = true;
+    while (not data.empty()) {
+      StringRef line;
+      std::tie(line, data) = data.split('\n');
+      if (line.empty()) {
+        inShortNames = false;
+      } else if (inShortNames) {
+        shortNames.push_back(line.split('\t'));
+      } else {
+        mangledNames.push_back(line);
+      }
     }
-    return newM;
+  }
+};
+
+// A PRISM library, loaded on the first lookup of one of its functions. The
+// module is read lazily: only the declarations of the functions are needed
+// to call them.
+class IRModule {
+public:
+  explicit IRModule(Module &M, const std::string &irFile)
+      : context(M.getContext()), irFile(irFile),
+        index(PrismNameIndex::get(irFile)) {}
+
+  auto hasFunction(const std::string &name) -> bool {
+    return not index.lookup(name).empty();
+  }
+
+  auto getFunction(const std::string &name) -> Function * {
+    if (not hasFunction(name)) {
+      return nullptr;
+    }
+    return getLibModule()->getFunction(index.lookup(name));
+  }
+
+  auto copyFunction(Module *M, Function *F,
+                    const std::string &functionName) -> FUNCTION_CALLEE {
+    auto functionNameMangled = index.lookup(functionName);
+
+    return M->getOrInsertFunction(functionNameMangled, F->getFunctionType(),
+                                  F->getAttributes());
+  }
+
+  auto isLibraryFunction(StringRef mangledName) -> bool {
+    return index.isLibraryFunction(mangledName);
+  }
+
+private:
+  LLVMContext &context;
+  std::string irFile;
+  const PrismNameIndex &index;
+  std::unique_ptr<Module> libModule = nullptr;
+
+  auto getLibModule() -> Module * {
+    if (libModule == nullptr) {
+      SMDiagnostic err;
+      libModule = getLazyIRFileModule(irFile, err, context);
+      if (libModule == nullptr) {
+        err.print(irFile.c_str(), errs());
+        prism_fatal_error("fatal error while reading library IR: " + irFile);
+      }
+    }
+    return libModule.get();
   }
 };
 
@@ -367,22 +491,16 @@ class PrismModule {
 private:
   options::RoundingMode rounding_mode;
   options::DispatchMode dispatch_mode;
-  IRModule staticLib;
-  IRModule dynamicLib;
+  // only the library of the dispatch mode is loaded
+  IRModule lib;
 
   auto getFunction(StringRef name) -> Function * {
-    if (dispatch_mode.is_static()) {
-      return staticLib.getFunction(name.str());
-    }
-    return dynamicLib.getFunction(name.str());
+    return lib.getFunction(name.str());
   }
 
   auto getCopyFunction(Module *M, Function *F,
                        const std::string &functionName) -> FUNCTION_CALLEE {
-    if (dispatch_mode.is_static()) {
-      return staticLib.copyFunction(M, F, functionName);
-    }
-    return dynamicLib.copyFunction(M, F, functionName);
+    return lib.copyFunction(M, F, functionName);
   }
 
   static auto getFloatingPointTypeName(Type *Ty) -> std::string {
@@ -407,13 +525,13 @@ private:
   }
 
   auto
-  getFunctionNameVector(Instruction *I, FPOps opCode,
+  getFunctionNameVector(Type *Ty, FPOps opCode,
                         const PrismPassingMode &passing_style) -> std::string {
     const auto mode = rounding_mode.get_namespace();
     const auto dispatch = dispatch_mode.get_namespace();
     const auto passing = PassingModeNamespace(passing_style);
     const auto opname = fops::getName(opCode);
-    const auto fpname = getFloatingPointTypeName(I->getType());
+    const auto fpname = getFloatingPointTypeName(Ty);
     const auto fname = opname + fpname;
 
     return "prism::" + mode + "::vector::" + dispatch + "::" + passing +
@@ -430,7 +548,7 @@ private:
     auto *baseType = I->getType();
 
     if (baseType->isVectorTy()) {
-      return getFunctionNameVector(I, opCode, passing);
+      return getFunctionNameVector(I->getType(), opCode, passing);
     }
 
     return getFunctionNameScalar(I, opCode);
@@ -443,8 +561,28 @@ public:
                        const cl::opt<std::string> &VfclibInstDynamicIRFile)
       : rounding_mode(std::move(rounding_mode)),
         dispatch_mode(std::move(dispatch_mode)),
-        staticLib(IRModule(M, VfclibInstStaticIRFile)),
-        dynamicLib(M, VfclibInstDynamicIRFile) {}
+        lib(M, this->dispatch_mode.is_static() ? VfclibInstStaticIRFile
+                                               : VfclibInstDynamicIRFile) {}
+
+  auto isLibraryFunction(StringRef mangledName) -> bool {
+    return lib.isLibraryFunction(mangledName);
+  }
+
+  // return the by-value prism function of the operation of I on vectors of
+  // lanes elements of its type, nullptr if the library does not define it or
+  // if the caller cannot call it
+  auto getByValueFunction(Instruction *I, const FPOps &opcode,
+                          unsigned lanes) -> Function * {
+    auto *type = GET_VECTOR_TYPE(I->getType()->getScalarType(), lanes);
+    auto functionName =
+        getFunctionNameVector(type, opcode, PrismPassingMode::ByValue);
+    Function *function = getFunction(functionName);
+    if (function == nullptr or not areABICompatible(I, function)) {
+      return nullptr;
+    }
+    auto F = getCopyFunction(I->getModule(), function, functionName);
+    return dyn_cast<Function>(F.getCallee());
+  }
 
   // return the corresponding prism function for the given instruction
   auto getPrismFunction(Instruction *I, const FPOps &opcode) -> PrismFunction {
@@ -634,7 +772,7 @@ struct VfclibInst : public ModulePass {
       const std::string &name = F.getName().str();
 
       // Function in the sr library to exclude
-      if (functionsToExclude.find(name) != functionsToExclude.end()) {
+      if (prismModule->isLibraryFunction(name)) {
         continue;
       }
 
@@ -897,9 +1035,91 @@ struct VfclibInst : public ModulePass {
     return result;
   }
 
+  // Width in bits of the vector registers of the caller, 0 if unknown
+  static auto getVectorRegisterBits(Function *caller) -> unsigned {
+    auto features = TargetFeatures(caller->getFnAttribute("target-features"));
+    return getVectorRegisterBits_X86_64(getHighestSupportedISA_X86_64(features));
+  }
+
+  // Apply F to each chunk of lanes elements of the operands of I, and
+  // concatenate the results
+  static auto createChunkedCall(IRBuilder<> &Builder, Instruction *I,
+                                Function *F, unsigned lanes) -> Value * {
+    const auto size = GET_VECTOR_ELEMENT_COUNT(I->getType());
+
+    std::vector<Value *> results;
+    for (unsigned first = 0; first < size; first += lanes) {
+      SmallVector<int, 64> mask;
+      for (unsigned i = 0; i < lanes; i++) {
+        mask.push_back(first + i);
+      }
+      std::vector<Value *> operands;
+      for (unsigned i = 0; i < fops::getArity(I); i++) {
+        operands.push_back(
+            Builder.CreateShuffleVector(I->getOperand(i), mask, "prism_chunk"));
+      }
+      auto *call = Builder.CreateCall(F, operands);
+      call->setAttributes(F->getAttributes());
+      results.push_back(call);
+    }
+
+    // the number of chunks is a power of two, merge them pairwise
+    while (results.size() > 1) {
+      std::vector<Value *> merged;
+      for (size_t i = 0; i < results.size(); i += 2) {
+        const auto width = GET_VECTOR_ELEMENT_COUNT(results[i]->getType());
+        SmallVector<int, 64> mask;
+        for (unsigned j = 0; j < 2 * width; j++) {
+          mask.push_back(j);
+        }
+        merged.push_back(Builder.CreateShuffleVector(
+            results[i], results[i + 1], mask, "prism_concat"));
+      }
+      results = merged;
+    }
+    return results.front();
+  }
+
+  // Vector operations without a by-value function usable by the caller are
+  // split in the widest chunks that fit in the vector registers of the caller
+  // and have one, so that the operands stay in registers instead of going
+  // through allocas (ByPointer). Return nullptr if the full width has a
+  // by-value function, or if no chunk width has one.
+  auto replaceWithByValueChunks(IRBuilder<> &Builder,
+                                Instruction *I) -> Value * {
+    const auto opcode = fops::getOpCode(I);
+    const auto size = GET_VECTOR_ELEMENT_COUNT(I->getType());
+    if (prismModule->getByValueFunction(I, opcode, size) != nullptr) {
+      return nullptr;
+    }
+
+    const auto scalarBits = I->getType()->getScalarSizeInBits();
+    const auto registerBits = getVectorRegisterBits(I->getFunction());
+    // 128 bits is the narrowest vector register
+    for (unsigned lanes = size / 2; lanes * scalarBits >= 128; lanes /= 2) {
+      if (registerBits != 0 and lanes * scalarBits > registerBits) {
+        continue;
+      }
+      Function *F = prismModule->getByValueFunction(I, opcode, lanes);
+      if (F != nullptr) {
+        if (debug_operands) {
+          errs() << "Split " << *I << " in chunks of " << lanes << " lanes\n";
+        }
+        return createChunkedCall(Builder, I, F, lanes);
+      }
+    }
+    return nullptr;
+  }
+
   /* Replace arithmetic instructions with PR */
   auto replaceArithmeticWithPRCall(IRBuilder<> &Builder,
                                    Instruction *I) -> Value * {
+    if (I->getType()->isVectorTy()) {
+      if (auto *result = replaceWithByValueChunks(Builder, I)) {
+        return result;
+      }
+    }
+
     auto F = getPrismFunction(I);
     if (F.getFunction() == nullptr) {
       // Skip instrumentation if the function is missing
@@ -1000,5 +1220,16 @@ extern "C" LLVM_ATTRIBUTE_WEAK PassPluginLibraryInfo llvmGetPassPluginInfo() {
                   }
                   return false;
                 });
+            // in-process instrumentation (clang -fpass-plugin), on the
+            // optimized module as with the opt chain of the driver
+            PB.registerOptimizerLastEPCallback(
+#if LLVM_VERSION_MAJOR >= 20
+                [](ModulePassManager &MPM, OptimizationLevel,
+                   ThinOrFullLTOPhase) {
+#else
+                [](ModulePassManager &MPM, OptimizationLevel) {
+#endif
+                  MPM.addPass(VfclibInstPass());
+                });
           }};
 }
@@ -112,6 +112,12 @@ static cl::opt<std::string> VfclibInstStaticIRFile(
     cl::desc("Name of the IR file that contains the static operators"),
     cl::value_desc("SRIRFile"), cl::init(""));
 
+static cl::opt<std::string> VfclibInstPrismIndexDir(
+    "vfclibinst-prism-index-dir",
+    cl::desc("Directory where the index of the PRISM library functions is "
+             "saved, the index is only kept in memory when empty"),
+    cl::value_desc("IndexDir"), cl::init(""));
+
 static cl::opt<bool> VfclibInstVerbose("vfclibinst-verbose",
                                        cl::desc("Activate verbose mode"),
                                        cl::value_desc("Verbose"),
@@ -137,12 +137,58 @@ def setup(args):
             """,
             action="store_true",
         ),
+        argument(
+            "-j",
+            "--jobs",
+            help="""
+            Number of repetitions of non-deterministic backends to execute at
+            once (1 by default). Each execution is pinned to its own share of
+            the available CPUs.
+            """,
+            type=int,
+            default=1,
+        ),
+        argument(
+            "-q",
+            "--queue",
+            help="""
+            Run the repetitions of non-deterministic backends through a job
+            queue in this directory, which must be on a filesystem shared with
+            the nodes running the workers (vfc_worker DIRECTORY). --jobs is
+            then the number of repetitions queued at once.
+            """,
+            type=str,
+        ),
+        argument(
+            "--max-samples",
+            help="""
+            Number of values of each probe of non-deterministic backends kept
+            for the normality test and the significant digits. Probes with
+            more values use a uniform sample of them, and their quantiles are
+            estimated, which bounds the memory used but changes the reported
+            numbers. By default, every value is kept and all the metrics are
+            exact.
+            """,
+            type=int,
+        ),
     ],
 )
 def test(args):
     import verificarlo.ci.test
 
-    verificarlo.ci.test.run(args.is_git_commit, args.export_raw_results, args.dry_run)
+    if args.jobs < 1:
+        cli.error("--jobs must be a positive integer")
+    if args.max_samples is not None and args.max_samples < 3:
+        cli.error("--max-samples must be at least 3")
+
+    verificarlo.ci.test.run(
+        args.is_git_commit,
+        args.export_raw_results,
+        args.dry_run,
+        args.jobs,
+        args.queue,
+        args.max_samples,
+    )
 
     # "serve" subcommand
 
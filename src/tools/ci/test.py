@@ -33,9 +33,15 @@ import sys
 import tempfile
 import time
 
+import numpy as np
 import pandas as pd
 
-from .test_data_processing import data_processing, validate_deterministic_probe
+from .. import executor
+from .test_data_processing import (
+    ProbesStatistics,
+    data_processing,
+    validate_deterministic_probe,
+)
 
 pickle.HIGHEST_PROTOCOL = 4
 
@@ -43,17 +49,100 @@ pickle.HIGHEST_PROTOCOL = 4
 # Magic numbers
 timeout = 600  # For commands execution
 
+# Binary columnar format of vfc_probes (see vfc_dump_probes)
+probes_binary_magic = b"VFCPROBE"
+probes_binary_version = 1
+probes_binary_header = np.dtype(
+    [
+        ("magic", "S8"),
+        ("version", "<u4"),
+        ("n_keys", "<u4"),
+        ("n_probes", "<u8"),
+        ("value_offset", "<u8"),
+        ("threshold_offset", "<u8"),
+        ("key_offset", "<u8"),
+        ("mode_offset", "<u8"),
+        ("dictionary_offset", "<u8"),
+    ]
+)
+probes_check_modes = np.array(["none", "absolute", "relative"], dtype=object)
+
 
 ##########################################################################
 
 # Helper functions
 
 
+def is_probes_binary(filepath):
+    """Check if a file outputted by vfc_probe uses the binary format"""
+
+    with open(filepath, "rb") as f:
+        return f.read(len(probes_binary_magic)) == probes_binary_magic
+
+
+def read_probes_binary(filepath):
+    """
+    Read a binary file outputted by vfc_probe as a Pandas dataframe. The value
+    columns are mapped in place, only the keys are decoded.
+    """
+
+    raw = np.memmap(filepath, dtype=np.uint8, mode="r")
+    header = np.frombuffer(raw, dtype=probes_binary_header, count=1)[0]
+    if header["version"] != probes_binary_version:
+        raise ValueError("unsupported probes file version")
+
+    n = int(header["n_probes"])
+    n_keys = int(header["n_keys"])
+
+    values = np.frombuffer(
+        raw, dtype="<f8", count=n, offset=int(header["value_offset"])
+    )
+    thresholds = np.frombuffer(
+        raw, dtype="<f8", count=n, offset=int(header["threshold_offset"])
+    )
+    keys = np.frombuffer(raw, dtype="<u4", count=n, offset=int(header["key_offset"]))
+    modes = np.frombuffer(
+        raw, dtype=np.uint8, count=n, offset=int(header["mode_offset"])
+    )
+
+    dictionary_offset = int(header["dictionary_offset"])
+    offsets = np.frombuffer(
+        raw, dtype="<u8", count=n_keys + 1, offset=dictionary_offset
+    )
+    strings = bytes(raw[dictionary_offset + 8 * (n_keys + 1) :])
+
+    # Keys are "test,variable", ',' being forbidden in the names
+    names = [
+        strings[offsets[i] : offsets[i + 1]].decode().split(",", 1)
+        for i in range(n_keys)
+    ]
+    tests = np.array([name[0] for name in names], dtype=object)
+    variables = np.array([name[1] for name in names], dtype=object)
+
+    return pd.DataFrame(
+        {
+            "test": tests[keys],
+            "variable": variables[keys],
+            "value": values,
+            "accuracy_threshold": thresholds,
+            "check_mode": probes_check_modes[modes],
+        }
+    )
+
+
 def read_probes_csv(filepath, warnings, execution_data):
-    """Read a CSV file outputted by vfc_probe as a Pandas dataframe"""
+    """
+    Read a file outputted by vfc_probe as a Pandas dataframe, in the CSV or the
+    binary format
+    """
 
+    binary = False
     try:
-        results = pd.read_csv(filepath)
+        binary = is_probes_binary(filepath)
+        if binary:
+            results = read_probes_binary(filepath)
+        else:
+            results = pd.read_csv(filepath)
 
     except FileNotFoundError:
         print(
@@ -107,14 +196,15 @@ def read_probes_csv(filepath, warnings, execution_data):
         )
         warnings.append(execution_data)
 
-    # Once the CSV has been opened and validated, return its content
-    results["value"] = results["value"].apply(lambda x: float.fromhex(x))
+    # Once the file has been opened and validated, return its content
+    # (the binary format already stores the doubles)
+    if not binary:
+        results["value"] = results["value"].apply(lambda x: float.fromhex(x))
+        results["accuracy_threshold"] = results["accuracy_threshold"].apply(
+            lambda x: float.fromhex(x)
+        )
     results.rename(columns={"value": "values"}, inplace=True)
 
-    results["accuracy_threshold"] = results["accuracy_threshold"].apply(
-        lambda x: float.fromhex(x)
-    )
-
     results["vfc_backend"] = execution_data["backend"]
 
     # Extract accuracy thresholds data
@@ -189,39 +279,99 @@ def generate_metadata(is_git_commit):
     return metadata
 
 
+def cpu_slots(jobs):
+    """
+    Split the CPUs available to vfc_ci in `jobs` disjoint sets, one for each
+    concurrent execution, so that multithreaded (e.g. OpenMP) tests size their
+    thread pools accordingly instead of oversubscribing the machine. A slot is
+    None when there is nothing to pin (sequential runs, more jobs than CPUs or
+    platforms without CPU affinity).
+    """
+
+    if jobs <= 1 or not hasattr(os, "sched_setaffinity"):
+        return [None] * max(jobs, 1)
+
+    cpus = sorted(os.sched_getaffinity(0))
+    if jobs > len(cpus):
+        return [None] * jobs
+
+    # Contiguous CPUs, to keep the threads of a run on the same cores/sockets
+    return [
+        set(cpus[k * len(cpus) // jobs : (k + 1) * len(cpus) // jobs])
+        for k in range(jobs)
+    ]
+
+
 def run_non_deterministic(
-    command, repetitions, executable, backend, data, checks_data, warnings
+    command,
+    repetitions,
+    executable,
+    backend,
+    statistics,
+    warnings,
+    jobs=1,
+    sample_executor=None,
 ):
     """
-    Loop execution for non-deterministic backends. This will also export checks
-    so they can be merged later with the data (after the likely duplicates have
-    been removed).
+    Loop execution for non-deterministic backends. The results and checks of
+    each repetition are added to the statistics of the probes. Up to `jobs`
+    repetitions are executed at once by `sample_executor` (local processes by
+    default), each one with its own probes file, and their results are added
+    in repetition order.
     """
 
-    # Run test repetitions and save results
-    for i in range(repetitions):
-        temp = tempfile.NamedTemporaryFile()
-        os.putenv("VFC_PROBES_OUTPUT", temp.name)
+    if sample_executor is None:
+        sample_executor = executor.LocalExecutor()
 
-        p = subprocess.Popen(command.split())
-        try:
-            p.wait(timeout)
-        except subprocess.TimeoutExpired:
-            print("Warning [vfc_ci]: execution was timed out", file=sys.stderr)
-            p.kill()
+    slots = cpu_slots(jobs)
+    free_slots = list(range(len(slots)))
+    pending = list(range(repetitions))
+    # slot -> (repetition, process, temp file, deadline)
+    running = {}
+    results = [None] * repetitions
+    next_result = 0
 
-        execution_data = {
-            "executable": executable,
-            "backend": backend,
-            "repetition": i + 1,
-        }
+    while pending or running:
+        # Start new repetitions on the free slots
+        while pending and free_slots:
+            i = pending.pop(0)
+            slot = free_slots.pop(0)
 
-        run_data, run_check_data = read_probes_csv(temp.name, warnings, execution_data)
+            # The probes file has to be visible from the node running the test
+            temp = tempfile.NamedTemporaryFile(dir=sample_executor.scratch_directory)
+            env = {"VFC_BACKENDS": backend, "VFC_PROBES_OUTPUT": temp.name}
 
-        data.append(run_data)
-        checks_data.append(run_check_data)
+            p = sample_executor.submit(command.split(), env, cpus=slots[slot])
+            running[slot] = (i, p, temp, time.monotonic() + timeout)
 
-        temp.close()
+        time.sleep(0.01)
+
+        # Collect the repetitions that are over
+        for slot, (i, p, temp, deadline) in list(running.items()):
+            if p.poll() is None:
+                if time.monotonic() < deadline:
+                    continue
+                print("Warning [vfc_ci]: execution was timed out", file=sys.stderr)
+                p.kill()
+                p.wait()
+
+            execution_data = {
+                "executable": executable,
+                "backend": backend,
+                "repetition": i + 1,
+            }
+
+            results[i] = read_probes_csv(temp.name, warnings, execution_data)
+            temp.close()
+
+            del running[slot]
+            free_slots.append(slot)
+
+        # Reduce in repetition order, whatever the completion order was
+        while next_result < repetitions and results[next_result] is not None:
+            statistics.add(*results[next_result])
+            results[next_result] = None
+            next_result += 1
 
 
 def run_deterministic(command, executable, backend, deterministic_data, warnings):
@@ -288,7 +438,7 @@ def run_deterministic(command, executable, backend, deterministic_data, warnings
     temp.close()
 
 
-def run_tests(config):
+def run_tests(config, jobs=1, keep_raw_values=False, queue=None, max_samples=None):
     """
     Execute tests and collect results in a Pandas dataframe
     """
@@ -297,13 +447,18 @@ def run_tests(config):
     print("Info [vfc_ci]: Building tests...")
     os.system(config["make_command"])
 
-    # These are arrays of Pandas dataframes for now
-    data = []
-    deterministic_data = []
+    # Ask for the binary probes format, which is faster to write and read. The
+    # format of each file is detected when reading it, so this is only a hint.
+    os.environ["VFC_PROBES_FORMAT"] = "binary"
 
-    # Only for non-deterministic data. Stored separately for now since it is
-    # easier to add this to data after the groupby.
-    checks_data = []
+    # Repetitions of non-deterministic backends are run locally, or by the
+    # workers of a shared queue
+    sample_executor = executor.get_executor(queue)
+
+    # Non-deterministic results are reduced as they come, deterministic ones
+    # are an array of Pandas dataframes for now
+    statistics = ProbesStatistics(keep_all=keep_raw_values, max_samples=max_samples)
+    deterministic_data = []
 
     # This will contain all executables/repetition numbers from which we could
     # not get any data
@@ -319,7 +474,7 @@ def run_tests(config):
 
         # Backends iteration
         for backend in executable["vfc_backends"]:
-            os.putenv("VFC_BACKENDS", backend["name"])
+            os.environ["VFC_BACKENDS"] = backend["name"]
 
             command = "./" + executable["executable"] + " " + parameters
 
@@ -333,9 +488,10 @@ def run_tests(config):
                     repetitions,
                     executable["executable"],
                     backend["name"],
-                    data,
-                    checks_data,
+                    statistics,
                     warnings,
+                    jobs,
+                    sample_executor,
                 )
 
             # However, if it is not specified, we'll assume a deterministic
@@ -352,34 +508,23 @@ def run_tests(config):
                 )
 
     # Make sure we have some data to work on
-    assert len(data) != 0 or len(deterministic_data) != 0, (
+    assert not statistics.empty() or len(deterministic_data) != 0, (
         "Error [vfc_ci]: No data have been generated "
         "by your tests executions, aborting run without writing results file"
     )
 
-    # Combine all separate executions in one dataframe
-    if len(data) > 0:
-        data = pd.concat(data, sort=False, ignore_index=True)
-        data = (
-            data.groupby(["test", "variable", "vfc_backend"])
-            .values.apply(list)
-            .reset_index()
-        )
-
-        data = data.set_index(["test", "variable", "vfc_backend"]).sort_index()
-        checks_data = pd.concat(checks_data, sort=False, ignore_index=True)
-        checks_data = checks_data.drop_duplicates(
-            subset=["test", "variable", "vfc_backend"]
-        )
-        checks_data = checks_data.reset_index()
-        del checks_data["index"]
-        checks_data = checks_data.set_index(
-            ["test", "variable", "vfc_backend"]
-        ).sort_index()
+    # Get the statistics of all separate executions in one dataframe
+    if not statistics.empty():
+        data = statistics.to_dataframe()
 
-        # Copy informations about accuracy thresholds to the main dataframe
-        data["accuracy_threshold"] = checks_data["accuracy_threshold"]
-        data["check_mode"] = checks_data["check_mode"]
+        sampled = (data["nsamples_used"] < data["nsamples"]).sum()
+        if sampled > 0:
+            print(
+                "Info [vfc_ci]: %s probe(s) have more than %s values: their "
+                "normality test and significant digits use a uniform sample of "
+                "%s values (--max-samples), and their quantiles are estimated."
+                % (sampled, max_samples, max_samples)
+            )
 
     else:
         data = pd.DataFrame()
@@ -420,7 +565,14 @@ def show_warnings(warnings):
 ##########################################################################
 
 
-def run(is_git_commit, export_raw_values, dry_run):
+def run(
+    is_git_commit,
+    export_raw_values,
+    dry_run,
+    jobs=1,
+    queue=None,
+    max_samples=None,
+):
     """Entry point of vfc_ci test"""
 
     # Get config, metadata and data
@@ -430,7 +582,9 @@ def run(is_git_commit, export_raw_values, dry_run):
     print("Info [vfc_ci]: Generating run metadata...")
     metadata = generate_metadata(is_git_commit)
 
-    data, deterministic_data, warnings = run_tests(config)
+    data, deterministic_data, warnings = run_tests(
+        config, jobs, export_raw_values, queue, max_samples
+    )
     show_warnings(warnings)
 
     # Data processing
@@ -19,6 +19,7 @@
 #############################################################################
 
 import numpy as np
+import pandas as pd
 import scipy.stats
 import significantdigits as sd
 
@@ -27,136 +28,398 @@ import significantdigits as sd
 min_pvalue = 0.05
 probability = 0.9
 confidence = 0.95
+# Capacity of each level of the quantile sketches
+sketch_size = 256
+# Number of probes whose significant digits are computed at once
+chunk_size = 256
 
 
 ##########################################################################
 
 
-def significant_digits(x):
-    """First wrapper to sd.significant_digits (returns results in base 2)"""
-
-    if x.mu == 0:
-        return 53
+def sample_chunks(values):
+    """
+    Split probes in chunks of at most chunk_size probes having the same number
+    of samples. Yields the positions of the probes of each chunk and their
+    samples, as a (samples x probes) ndarray.
+    """
 
-    # If the null hypothesis is rejected, call sigdigits with the General
-    # formula:
-    if x.pvalue < min_pvalue:
-        # In a pandas DF, "values" actually refers to the array of columns, and
-        # not the column named "values"
-        distribution = x.values[0]
-        distribution = distribution.reshape(len(distribution), 1)
+    sizes = np.array([len(v) for v in values], dtype=np.int64)
+    for size in np.unique(sizes):
+        positions = np.flatnonzero(sizes == size)
+        for start in range(0, len(positions), chunk_size):
+            chunk = positions[start : start + chunk_size]
+            yield chunk, np.stack([values[i] for i in chunk], axis=1)
 
-        # The distribution's empirical average will be used as the reference
-        mu = np.array([x.mu])
 
-        s = sd.significant_digits(
-            distribution,
-            mu,
-            error=sd.Error.Relative,
-            method=sd.Method.General,
-            probability=probability,
-            confidence=confidence,
-        )
-
-        # s is returned inside a list
-        return s[0]
+def sd_significant_digits(samples, mu, method, probability, confidence):
+    """
+    Call sd.significant_digits on several probes at once (one probe per column
+    of samples), with the empirical averages as references. Results are
+    returned in base 2.
+    """
 
-    # Else, manually compute sMCA (Stott-Parker formula)
-    else:
-        return min(-np.log2(np.absolute(x.sigma / x.mu)), 53)
+    return sd.significant_digits(
+        samples,
+        mu,
+        error=sd.Error.Relative,
+        method=method,
+        probability=probability,
+        confidence=confidence,
+    )
 
 
-def significant_digits_lower_bound(x):
+def significant_digits(values, mu, sigma, pvalue):
     """
-    Second wrapper to sd.significant_digits : assumes that s2 has already been
-    computed
+    Compute the significant digits of all probes and the lower bound of their
+    confidence interval (in base 2). values holds the samples of each probe,
+    and mu, sigma and pvalue are arrays of their statistics.
+
+    For each probe :
+    - if mu is 0, s2 = 53
+    - if the null hypothesis of normality is rejected, s2 is computed with the
+    General formula, and there is no lower bound (s2_lower_bound = s2)
+    - else, s2 is computed with the Stott-Parker formula (sMCA), and the lower
+    bound with the CNH formula (p = .9, alpha - 1 = .95)
     """
 
-    # If the null hypothesis is rejected, no lower bound
-    if x.pvalue < min_pvalue:
-        return x.s2
+    with np.errstate(divide="ignore", invalid="ignore"):
+        s2 = np.minimum(-np.log2(np.absolute(sigma / mu)), 53)
+    s2[mu == 0] = 53
 
-    elif x.mu == 0:
-        return 53
+    general = (pvalue < min_pvalue) & (mu != 0)
+    cnh = ~(pvalue < min_pvalue) & (mu != 0)
 
-    # Else, the lower bound will be computed with p= .9 alpha-1=.95
-    else:
-        distribution = x.values[0]
-        distribution = distribution.reshape(len(distribution), 1)
+    s2_lower_bound = np.full(len(mu), 53.0)
 
-        mu = np.array([x.mu])
+    for chunk, samples in sample_chunks(values):
+        selected = general[chunk]
+        if selected.any():
+            s2[chunk[selected]] = sd_significant_digits(
+                samples[:, selected],
+                mu[chunk[selected]],
+                sd.Method.General,
+                probability,
+                confidence,
+            )
 
-        s = sd.significant_digits(
-            distribution,
-            mu,
-            error=sd.Error.Relative,
-            method=sd.Method.CNH,
-            probability=0.9,
-            confidence=0.95,
-        )
-        return s[0]
+        selected = cnh[chunk]
+        if selected.any():
+            s2_lower_bound[chunk[selected]] = sd_significant_digits(
+                samples[:, selected],
+                mu[chunk[selected]],
+                sd.Method.CNH,
+                0.9,
+                0.95,
+            )
+
+    no_bound = pvalue < min_pvalue
+    s2_lower_bound[no_bound] = s2[no_bound]
+
+    return s2, s2_lower_bound
 
 
-def apply_data_pocessing(data):
+class QuantileSketches:
     """
-    This function computes most test metrics (mu, sigma, quantiles, ...).
-    Doesn't include significant digits.
+    KLL-like quantile sketches of several probes, updated at once. Each level
+    of a sketch holds up to sketch_size values, the values of level l standing
+    for 2**l values each. A full level is sorted and compacted: every other
+    value, starting at a random offset, is moved to the next level. The rank
+    error of a quantile is about the number of levels over sketch_size, and
+    sketches built from disjoint sets of values can be merged by compacting
+    the concatenation of their levels.
     """
 
-    # Get empirical average, standard deviation and p-value
-    data["mu"] = np.average(data["values"])
-    data["sigma"] = np.std(data["values"])
-    data["pvalue"] = scipy.stats.shapiro(data["values"]).pvalue
+    def __init__(self, rng, k=sketch_size):
+        self.rng = rng
+        self.k = k
+        self.rows = 0
+        self.levels = []
+        self.fills = []
+
+    def _grow(self, n_rows, n_levels):
+        """Make room for n_rows sketches of n_levels levels"""
+
+        if n_rows > self.rows:
+            rows = max(n_rows, 2 * self.rows)
+            for level in range(len(self.levels)):
+                buffer = np.zeros((rows, self.k))
+                buffer[: self.rows] = self.levels[level]
+                self.levels[level] = buffer
+                fill = np.zeros(rows, dtype=np.int64)
+                fill[: self.rows] = self.fills[level]
+                self.fills[level] = fill
+            self.rows = rows
+
+        while len(self.levels) < n_levels:
+            self.levels.append(np.zeros((self.rows, self.k)))
+            self.fills.append(np.zeros(self.rows, dtype=np.int64))
+
+    def _insert(self, level, rows, items):
+        """
+        Append the items (one row of items per sketch of rows) to a level. A
+        level is compacted as soon as it is full, and items come one at a
+        time or by half levels, so they always fit.
+        """
+
+        self._grow(self.rows, level + 1)
+        fill = self.fills[level][rows]
+        width = items.shape[1]
+        self.levels[level][rows[:, None], fill[:, None] + np.arange(width)] = items
+        self.fills[level][rows] = fill + width
+
+        full = rows[self.fills[level][rows] == self.k]
+        if len(full) > 0:
+            values = np.sort(self.levels[level][full], axis=1)
+            offsets = self.rng.integers(0, 2, len(full))
+            half = np.arange(self.k // 2) * 2
+            compacted = values[np.arange(len(full))[:, None], half + offsets[:, None]]
+            self.fills[level][full] = 0
+            self._insert(level + 1, full, compacted)
+
+    def add(self, rows, x):
+        """Add one value to each sketch of rows (which must be unique)"""
+
+        self._grow(rows.max() + 1, 1)
+        self._insert(0, rows, x[:, None])
+
+    def quantiles(self, rows, q):
+        """Estimated quantiles q of the sketches of rows, one row per sketch"""
+
+        values = np.concatenate([level[rows] for level in self.levels], axis=1)
+        weights = np.concatenate(
+            [
+                np.where(np.arange(self.k) < fill[rows][:, None], 2.0**level, 0.0)
+                for level, fill in enumerate(self.fills)
+            ],
+            axis=1,
+        )
+        # empty slots are sorted last
+        values[weights == 0] = np.inf
+        order = np.argsort(values, axis=1)
+        values = np.take_along_axis(values, order, axis=1)
+        ranks = np.cumsum(np.take_along_axis(weights, order, axis=1), axis=1)
 
-    # Quantiles
-    data["min"] = np.min(data["values"])
-    data["quantile25"] = np.quantile(data["values"], 0.25)
-    data["quantile50"] = np.quantile(data["values"], 0.50)
-    data["quantile75"] = np.quantile(data["values"], 0.75)
-    data["max"] = np.max(data["values"])
+        result = np.empty((len(rows), len(q)))
+        for i, quantile in enumerate(q):
+            target = quantile * ranks[:, -1:]
+            index = np.argmax(ranks >= target, axis=1)
+            result[:, i] = values[np.arange(len(rows)), index]
+        return result
 
-    # Check validation
 
-    if data["check_mode"] == "absolute":
-        data["check"] = (
-            True if data["sigma"] < abs(data["accuracy_threshold"]) else False
-        )
+class ProbesStatistics:
+    """
+    Streaming reduction of the probes of non-deterministic backends. Runs are
+    added one after another, and each probe keeps its running moments
+    (Welford's algorithm), its extrema and its values. By default every value
+    is kept and all the metrics are exact. With max_samples, each probe only
+    keeps a uniform reservoir sample of at most max_samples of its values and
+    a quantile sketch: the sample stands for the whole distribution in the
+    normality test and the significant digits, and the quantiles are
+    estimated, so memory no longer grows with the number of repetitions. With
+    keep_all (for the raw results export), every value is kept in any case.
+    """
 
-    elif data["check_mode"] == "relative":
-        data["check"] = (
-            True
-            if abs(data["sigma"] / data["mu"]) < abs(data["accuracy_threshold"])
-            else False
+    def __init__(self, keep_all=False, max_samples=None, seed=0):
+        self.limit = None if keep_all else max_samples
+        # Fixed seed, so that a run file only depends on the probes values
+        self.rng = np.random.default_rng(seed)
+
+        # (test, variable, vfc_backend) -> row
+        self.rows = {}
+        self.keys = []
+        self.thresholds = []
+        self.modes = []
+
+        self.count = np.zeros(0, dtype=np.int64)
+        self.mean = np.zeros(0)
+        self.m2 = np.zeros(0)
+        self.min = np.zeros(0)
+        self.max = np.zeros(0)
+        self.samples = np.zeros((0, 0))
+        # Own generator, so that the reservoir does not depend on the sketches
+        self.sketches = QuantileSketches(np.random.default_rng(seed + 1))
+
+    def empty(self):
+        return len(self.keys) == 0
+
+    def _grow(self, n_rows, n_samples):
+        """Make room for n_rows probes and n_samples samples per probe"""
+
+        rows, width = self.samples.shape
+        if n_rows <= rows and n_samples <= width:
+            return
+
+        if n_rows > rows:
+            rows = max(n_rows, 2 * rows)
+        if n_samples > width:
+            width = max(n_samples, 2 * width)
+            if self.limit is not None:
+                width = min(width, self.limit)
+
+        def resize(array, fill):
+            resized = np.full(rows, fill, dtype=array.dtype)
+            resized[: len(array)] = array
+            return resized
+
+        self.count = resize(self.count, 0)
+        self.mean = resize(self.mean, 0)
+        self.m2 = resize(self.m2, 0)
+        self.min = resize(self.min, np.inf)
+        self.max = resize(self.max, -np.inf)
+
+        samples = np.zeros((rows, width))
+        samples[: self.samples.shape[0], : self.samples.shape[1]] = self.samples
+        self.samples = samples
+
+    def _update(self, rows, x):
+        """Add one value to each probe of rows (which must be unique)"""
+
+        n = self.count[rows] + 1
+        self.count[rows] = n
+
+        delta = x - self.mean[rows]
+        self.mean[rows] += delta / n
+        self.m2[rows] += delta * (x - self.mean[rows])
+
+        self.min[rows] = np.minimum(self.min[rows], x)
+        self.max[rows] = np.maximum(self.max[rows], x)
+
+        if self.limit is not None:
+            self.sketches.add(rows, x)
+
+        # Reservoir sampling (algorithm R): once the reservoir is full, the
+        # n-th value replaces a random sample with probability limit / n
+        slots = n - 1
+        if self.limit is not None:
+            full = n > self.limit
+            slots[full] = self.rng.integers(0, n[full])
+            kept = slots < self.limit
+            rows, x, slots = rows[kept], x[kept], slots[kept]
+
+        if len(slots) > 0:
+            self._grow(self.samples.shape[0], slots.max() + 1)
+            self.samples[rows, slots] = x
+
+    def add(self, run_data, run_checks_data):
+        """
+        Add the results of a run, as returned by read_probes_csv. The checks of
+        a probe are the ones of the first run where it appears.
+        """
+
+        if len(run_data) == 0:
+            return
+
+        rows = np.empty(len(run_data), dtype=np.int64)
+        keys = zip(run_data["test"], run_data["variable"], run_data["vfc_backend"])
+        checks = zip(
+            run_checks_data["accuracy_threshold"], run_checks_data["check_mode"]
+        )
+        for i, (key, check) in enumerate(zip(keys, checks)):
+            row = self.rows.get(key)
+            if row is None:
+                row = len(self.keys)
+                self.rows[key] = row
+                self.keys.append(key)
+                self.thresholds.append(check[0])
+                self.modes.append(check[1])
+            rows[i] = row
+
+        self._grow(len(self.keys), 0)
+
+        # A probe recorded several times in a run (time series) contributes
+        # all its values, processed in successive layers of unique probes
+        values = run_data["values"].to_numpy(dtype=np.float64)
+        rank = pd.Series(rows).groupby(rows).cumcount().to_numpy()
+        for r in range(rank.max() + 1):
+            layer = rank == r
+            self._update(rows[layer], values[layer])
+
+    def to_dataframe(self):
+        """
+        Return the statistics as a dataframe indexed by test, variable and
+        backend. The "values" column holds the sample of each probe, of
+        "nsamples_used" values. The quartiles of the probes whose values are
+        not all sampled are estimated from their sketches.
+        """
+
+        n = len(self.keys)
+        count = self.count[:n]
+        sizes = count if self.limit is None else np.minimum(count, self.limit)
+
+        quartiles = np.full((n, 3), np.nan)
+        sampled = np.flatnonzero(sizes < count)
+        if len(sampled) > 0:
+            quartiles[sampled] = self.sketches.quantiles(sampled, [0.25, 0.50, 0.75])
+
+        data = pd.DataFrame(
+            {
+                "values": [self.samples[i, : sizes[i]].copy() for i in range(n)],
+                "nsamples": count,
+                "nsamples_used": sizes,
+                "mu": self.mean[:n],
+                "sigma": np.sqrt(self.m2[:n] / count),
+                "min": self.min[:n],
+                "max": self.max[:n],
+                "accuracy_threshold": self.thresholds,
+                "check_mode": self.modes,
+                "quantile25": quartiles[:, 0],
+                "quantile50": quartiles[:, 1],
+                "quantile75": quartiles[:, 2],
+            },
+            index=pd.MultiIndex.from_tuples(
+                self.keys, names=["test", "variable", "vfc_backend"]
+            ),
         )
 
-    else:
-        data["check"] = True
-
-    return data
+        return data.sort_index()
 
 
 def data_processing(data):
     """
-    Computes all metrics on the dataframe
+    Computes all metrics on the dataframe returned by
+    ProbesStatistics.to_dataframe. The average, standard deviation and extrema
+    have been computed online, the other metrics are computed from the samples
+    of the probes.
     """
 
-    # Converts classic lists to Numpy arrays
-    data["values"] = data["values"].apply(lambda x: np.array(x))
+    values = data["values"].tolist()
+    mu = data["mu"].to_numpy(dtype=np.float64)
+    sigma = data["sigma"].to_numpy(dtype=np.float64)
 
-    # Computes most of test metrics
-    data = data.apply(apply_data_pocessing, axis=1)
+    # Get p-value
+    pvalue = np.array([scipy.stats.shapiro(v).pvalue for v in values])
+    data["pvalue"] = pvalue
 
-    # Significant digits
-    data["s2"] = data.apply(significant_digits, axis=1)
-    data["s10"] = data["s2"].apply(lambda x: sd.change_basis(x, 10))
+    # Quantiles, exact when every value was kept, and estimated by the
+    # sketches otherwise
+    quantiles = np.empty((len(values), 3))
+    for chunk, samples in sample_chunks(values):
+        quantiles[chunk] = np.quantile(samples, [0.25, 0.50, 0.75], axis=0).T
+    sketched = (data["nsamples_used"] < data["nsamples"]).to_numpy()
+    for i, column in enumerate(["quantile25", "quantile50", "quantile75"]):
+        data[column] = np.where(sketched, data[column], quantiles[:, i])
 
-    # Lower bound of the confidence interval using the sigdigits module
-    data["s2_lower_bound"] = data.apply(significant_digits_lower_bound, axis=1)
-    data["s10_lower_bound"] = data["s2_lower_bound"].apply(
-        lambda x: sd.change_basis(x, 10)
+    # Check validation
+    threshold = np.absolute(data["accuracy_threshold"].to_numpy(dtype=np.float64))
+    mode = data["check_mode"].to_numpy()
+    with np.errstate(divide="ignore", invalid="ignore"):
+        relative_error = np.absolute(sigma / mu)
+    data["check"] = np.where(
+        mode == "absolute",
+        sigma < threshold,
+        np.where(mode == "relative", relative_error < threshold, True),
     )
 
-    data["nsamples"] = data["values"].apply(len)
+    # Significant digits
+    s2, s2_lower_bound = significant_digits(values, mu, sigma, pvalue)
+    data["s2"] = s2
+    data["s10"] = sd.change_basis(s2, 10)
+
+    # Lower bound of the confidence interval using the sigdigits module
+    data["s2_lower_bound"] = s2_lower_bound
+    data["s10_lower_bound"] = sd.change_basis(s2_lower_bound, 10)
 
     return data
 
@@ -267,7 +267,7 @@ class InspectRuns:
         self.current_run = self.runs_dict[new]
 
         # Update run data
-        self.run_data = self.data[self.data["timestamp"] == self.current_run]
+        self.run_data = self.master.read_run(self.current_run)
 
         # Save old selected option
         old_value = self.widgets["select_filter"].value
@@ -491,7 +491,7 @@ class InspectRuns:
         # Contains the selected option string, used to update current_n_runs
         current_run_display = runs_display[-1]
         # This contains only entries matching the run
-        self.run_data = self.data[self.data["timestamp"] == self.current_run]
+        self.run_data = self.master.read_run(self.current_run)
 
         change_run_callback_js = 'updateRunMetadata(cb_obj.value, "");'
 
@@ -604,7 +604,7 @@ class InspectRuns:
         ]
         filterby = self.factors_dict[filterby]
 
-        self.run_data = self.data[self.data["timestamp"] == self.current_run]
+        self.run_data = self.master.read_run(self.current_run)
         options = (
             self.run_data.index.get_level_values(filterby).drop_duplicates().tolist()
         )
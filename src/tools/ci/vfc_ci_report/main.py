@@ -21,7 +21,6 @@
 # Look for and read all the run files in the current directory (ending with
 # .vfcrun.h5), and lanch a Bokeh server for the visualization of this data.
 
-import os
 import sys
 import time
 import json
@@ -38,6 +37,7 @@ import inspect_runs
 import checks
 
 import helper
+from run_index import RunIndex
 
 ##########################################################################
 
@@ -81,32 +81,17 @@ curdoc().template_variables["has_logo"] = has_logo
 ##########################################################################
 
 
-# Read vfcrun files, and aggregate them in one dataset
+# Index new vfcrun files, then read the metadata of all runs and the data of
+# the selected runs from the index
 
-run_files = [f for f in os.listdir(directory) if f.endswith(".vfcrun.h5")]
+run_index = RunIndex(directory)
+run_index.update()
 
-if len(run_files) == 0:
-    print(
-        "Warning [vfc_ci]: Could not find any vfcrun files in the directory. "
-        "This will result in server errors and prevent you from viewing the report."
-    )
-
-# These are arrays of Pandas dataframes for now
-metadata = []
-data = []
-deterministic_data = []
-
-# First pass for metadata
-for f in run_files:
-    path = os.path.normpath(directory + "/" + f)
-    metadata.append(pd.read_hdf(path, "metadata"))
-    current_metadata = pd.read_hdf(path, "metadata")
-
-metadata = pd.concat(metadata).sort_index()
+metadata = run_index.read_metadata()
 
 if len(metadata) == 0:
     print(
-        "Warning [vfc_ci]: No run files matched the specified timeframe. "
+        "Warning [vfc_ci]: Could not find any vfcrun files in the directory. "
         "This will result in server errors and prevent you from viewing the report."
         "If you did not expect this, make sure that you have correctly "
         "specified the directory containing the run files.",
@@ -131,22 +116,8 @@ metadata = metadata.head(max_files)
 # Maximal acceptable timestamp
 max_timestamp = metadata.iloc[max_files - 1].name
 
-# Second pass for data (now that we know which files to load entirely)
-for f in run_files:
-    # We have to read the metadata again to get back the timestamp.
-    # Then, depending of the timestamp value, data will be read or dismissed
-    path = os.path.normpath(directory + "/" + f)
-    current_metadata = pd.read_hdf(path, "metadata")
-    current_timestamp = current_metadata.iloc[0].name
-
-    if current_timestamp <= max_timestamp:
-        data.append(pd.read_hdf(directory + "/" + f, "data"))
-        deterministic_data.append(
-            pd.read_hdf(directory + "/" + f, "deterministic_data")
-        )
-
-data = pd.concat(data).sort_index()
-deterministic_data = pd.concat(deterministic_data).sort_index()
+# Only the runs up to this timestamp are read
+data, deterministic_data = run_index.read_data(metadata.iloc[0].name, max_timestamp)
 
 # If no data/deterministic_data has been found, create an empty dataframe anyway
 # (with column names) to avoid errors further in the code
@@ -256,6 +227,9 @@ class ViewsMaster:
     def go_to_checks(self, run_name):
         self.checks.switch_view(run_name)
 
+    def read_run(self, timestamp):
+        return run_index.read_run(timestamp)
+
         # Constructor
 
     def __init__(self, data, deterministic_data, metadata):
@@ -0,0 +1,218 @@
+##############################################################################\
+#                                                                           #\
+#  This file is part of the Verificarlo project,                            #\
+#  under the Apache License v2.0 with LLVM Exceptions.                      #\
+#  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 #\
+#  See https://llvm.org/LICENSE.txt for license information.                #\
+#                                                                           #\
+#                                                                           #\
+#  Copyright (c) 2019-2026                                                  #\
+#     Verificarlo Contributors                                              #\
+#                                                                           #\
+#############################################################################
+
+# Persistent index of the run files of a directory, so that the report server
+# does not have to open every .vfcrun.h5 file at startup.
+#
+# The index is a single HDF5 file stored next to the run files. The per-probe
+# statistics of all runs are appended to two tables ("data" and
+# "deterministic_data") that can be queried by timestamp, so only the runs
+# displayed by the report are read. The list of indexed files and the
+# metadata of the runs (one row per run) are small and rewritten on update.
+
+import os
+import sys
+import tempfile
+
+import pandas as pd
+
+# Magic numbers
+index_filename = "vfcruns.index.h5"
+# Minimal size reserved for the strings of the tables (longer strings trigger
+# a rewrite of the table)
+min_string_size = 128
+complevel = 5
+
+##########################################################################
+
+
+def file_signature(path):
+    """Size and modification time of a file, used to detect changes"""
+
+    stat = os.stat(path)
+    return stat.st_size, stat.st_mtime_ns
+
+
+def string_sizes(df):
+    """Size to reserve for each string column (and index level) of df"""
+
+    sizes = {}
+    columns = [df[c] for c in df.columns if df[c].dtype == object]
+    columns += [
+        df.index.get_level_values(level).to_series()
+        for level in range(df.index.nlevels)
+        if df.index.get_level_values(level).dtype == object
+    ]
+    for column in columns:
+        longest = column.astype(str).str.len().max()
+        longest = 0 if pd.isna(longest) else int(longest)
+        sizes[column.name] = max(min_string_size, 2 * longest)
+
+    return sizes
+
+
+class RunIndex:
+    """
+    Index of the .vfcrun.h5 files of a directory. Call update() to add the new
+    (or modified) run files, then read the metadata of all runs and the
+    statistics of the runs to display.
+    """
+
+    def __init__(self, directory):
+        self.directory = directory
+        self.path = os.path.join(directory, index_filename)
+
+        # Fall back to a temporary index if the results directory is read-only
+        if not os.access(directory, os.W_OK):
+            print(
+                "Warning [vfc_ci]: The results directory is not writable, the "
+                "run index will not be kept after this session.",
+                file=sys.stderr,
+            )
+            fd, self.path = tempfile.mkstemp(suffix=".h5")
+            os.close(fd)
+            os.remove(self.path)
+
+    def _select(self, key, where=None):
+        with pd.HDFStore(self.path, mode="r") as store:
+            if key not in store:
+                return pd.DataFrame()
+            return store.select(key, where=where)
+
+    def _append(self, store, key, df):
+        """Append df to a table, rewriting the table if df does not fit"""
+
+        if df.empty:
+            return
+
+        try:
+            store.append(
+                key,
+                df,
+                format="table",
+                data_columns=["timestamp"],
+                min_itemsize=string_sizes(df),
+                complevel=complevel,
+            )
+        except (ValueError, TypeError):
+            # New columns, other types or longer strings than the ones
+            # reserved: rewrite the whole table
+            df = pd.concat([store.select(key), df]) if key in store else df
+            store.remove(key)
+            store.append(
+                key,
+                df,
+                format="table",
+                data_columns=["timestamp"],
+                min_itemsize=string_sizes(df),
+                complevel=complevel,
+            )
+
+    def update(self):
+        """Index the run files that are new or modified since last update"""
+
+        run_files = sorted(
+            f for f in os.listdir(self.directory) if f.endswith(".vfcrun.h5")
+        )
+
+        indexed = pd.DataFrame()
+        if os.path.exists(self.path):
+            indexed = self._select("files")
+
+        known = {}
+        if not indexed.empty:
+            for name, row in indexed.iterrows():
+                known[name] = (row["size"], row["mtime"])
+
+        signatures = {
+            f: file_signature(os.path.join(self.directory, f)) for f in run_files
+        }
+        new_files = [f for f in run_files if known.get(f) != signatures[f]]
+
+        # Runs whose file disappeared or changed are removed from the index
+        stale = [f for f in known if known[f] != signatures.get(f)]
+
+        if len(new_files) == 0 and len(stale) == 0:
+            return
+
+        print(
+            "Info [vfc_ci]: Indexing %s new run file(s)..." % len(new_files),
+            file=sys.stderr,
+        )
+
+        with pd.HDFStore(self.path, mode="a") as store:
+            metadata = store["metadata"] if "metadata" in store else pd.DataFrame()
+
+            if len(stale) != 0:
+                stale_timestamps = [int(t) for t in indexed.loc[stale, "timestamp"]]
+                for key in ["data", "deterministic_data"]:
+                    if key in store:
+                        store.remove(key, where="timestamp in %s" % stale_timestamps)
+                metadata = metadata.drop(stale_timestamps, errors="ignore")
+                indexed = indexed.drop(stale)
+
+            new_metadata = []
+            new_entries = []
+            for f in new_files:
+                path = os.path.join(self.directory, f)
+                run_metadata = pd.read_hdf(path, "metadata")
+                timestamp = run_metadata.iloc[0].name
+
+                self._append(store, "data", pd.read_hdf(path, "data"))
+                self._append(
+                    store,
+                    "deterministic_data",
+                    pd.read_hdf(path, "deterministic_data"),
+                )
+
+                new_metadata.append(run_metadata)
+                size, mtime = signatures[f]
+                new_entries.append(
+                    pd.DataFrame(
+                        {"size": [size], "mtime": [mtime], "timestamp": [timestamp]},
+                        index=[f],
+                    )
+                )
+
+            store.put("metadata", pd.concat([metadata] + new_metadata).sort_index())
+            store.put("files", pd.concat([indexed] + new_entries))
+
+    def read_metadata(self):
+        """Metadata of all the indexed runs"""
+
+        if not os.path.exists(self.path):
+            return pd.DataFrame()
+        return self._select("metadata").sort_index()
+
+    def read_data(self, min_timestamp, max_timestamp):
+        """
+        Statistics of the runs between two timestamps (included), as a
+        (data, deterministic_data) tuple
+        """
+
+        if not os.path.exists(self.path):
+            return pd.DataFrame(), pd.DataFrame()
+
+        where = "timestamp >= %s & timestamp <= %s" % (
+            int(min_timestamp),
+            int(max_timestamp),
+        )
+        return (
+            self._select("data", where).sort_index(),
+            self._select("deterministic_data", where).sort_index(),
+        )
+
+    def read_run(self, timestamp):
+        """Statistics of a single run, read on demand"""
+
+        return self._select("data", "timestamp == %s" % int(timestamp)).sort_index()
@@ -324,6 +324,18 @@ class DD:
         """Stub to overload in subclasses"""
         return self.UNRESOLVED  # Placeholder
 
+    def test_first_fail(self, cs, nbRun, trying=None):
+        """Return the index of the first configuration of CS whose test
+        fails, None if they all pass.  If given, TRYING(C) returns the
+        message to print before testing C.  Subclasses may test the
+        configurations concurrently, as long as the result is the same."""
+        for i in range(len(cs)):
+            if trying is not None:
+                print(trying(cs[i]))
+            if self._test(cs[i], nbRun) == self.FAIL:
+                return i
+        return None
+
     # Splitting
 
     def split(self, c, n):
@@ -782,28 +794,28 @@ class DD:
             next_n = n
 
             # Check subsets
-            for i in range(n):
-                if self.debug_dd:
-                    print(algo_name + ": trying", self.pretty(cs[i]))
+            trying = None
+            if self.debug_dd:
+                def trying(c):
+                    return algo_name + ": trying " + self.pretty(c)
 
-                t = self._test(cs[i], nbRun)
+            i = self.test_first_fail(cs, nbRun, trying)
 
-                if t == self.FAIL:
-                    # Found
-                    if self.debug_dd:
-                        print(
-                            algo_name + ": found",
-                            len(cs[i]),
-                            "deltas:",
-                        )
-                        print(self.pretty(cs[i]))
+            if i is not None:
+                # Found
+                if self.debug_dd:
+                    print(
+                        algo_name + ": found",
+                        len(cs[i]),
+                        "deltas:",
+                    )
+                    print(self.pretty(cs[i]))
 
-                    c_failed = True
-                    next_c = cs[i]
-                    next_n = 2
-                    cbar_offset = 0
-                    self.report_progress(next_c, algo_name)
-                    break
+                c_failed = True
+                next_c = cs[i]
+                next_n = 2
+                cbar_offset = 0
+                self.report_progress(next_c, algo_name)
 
             if not c_failed:
                 # Check complements
@@ -811,28 +823,29 @@ class DD:
 
                 # print "cbar_offset =", cbar_offset
 
-                for j in range(n):
-                    i = (j + cbar_offset) % n
+                order = [(j + cbar_offset) % n for j in range(n)]
+                for i in order:
                     cbars[i] = self.__listminus(c, cs[i])
-                    t = self._test(cbars[i], nbRun)
 
-                    if t == self.FAIL:
-                        if self.debug_dd:
-                            print(
-                                algo_name + ": reduced to",
-                                len(cbars[i]),
-                            )
-                            print("deltas:", end="")
-                            print(self.pretty(cbars[i]))
+                j = self.test_first_fail([cbars[i] for i in order], nbRun)
 
-                        cbar_failed = True
-                        next_c = cbars[i]
-                        next_n = next_n - 1
-                        self.report_progress(next_c, algo_name)
+                if j is not None:
+                    i = order[j]
+                    if self.debug_dd:
+                        print(
+                            algo_name + ": reduced to",
+                            len(cbars[i]),
+                        )
+                        print("deltas:", end="")
+                        print(self.pretty(cbars[i]))
 
-                        # In next run, start removing the following subset
-                        cbar_offset = i
-                        break
+                    cbar_failed = True
+                    next_c = cbars[i]
+                    next_n = next_n - 1
+                    self.report_progress(next_c, algo_name)
+
+                    # In next run, start removing the following subset
+                    cbar_offset = i
 
             if not c_failed and not cbar_failed:
                 if n >= len(c):
@@ -2,11 +2,16 @@ import sys
 import os
 
 import subprocess
+import threading
+import time
 
 import shutil
 import hashlib
 import copy
+from concurrent.futures import ThreadPoolExecutor, FIRST_COMPLETED, wait
 from . import DD
+from . import dd_cache
+from .. import executor
 
 
 def runCmdAsync(cmd, fname, envvars=None):
@@ -41,7 +46,9 @@ def runCmd(cmd, fname, envvars=None):
 
 class InterflopTask:
 
-    def __init__(self, dirname, refDir, runCmd, cmpCmd, nbRun, maxNbPROC, runEnv):
+    def __init__(self, dirname, refDir, runCmd, cmpCmd, nbRun, maxNbPROC, runEnv,
+                 cache=None, cacheKey=None, cancelled=None, sampleExecutor=None,
+                 slots=None, header=""):
         self.dirname = dirname
         self.refDir = refDir
         self.runCmd = runCmd
@@ -49,12 +56,54 @@ class InterflopTask:
         self.nbRun = nbRun
         self.FAIL = DD.DD.FAIL
         self.PASS = DD.DD.PASS
+        self.UNRESOLVED = DD.DD.UNRESOLVED
 
         self.subProcessRun = {}
         self.maxNbPROC = maxNbPROC
         self.runEnv = runEnv
-
-        print(self.dirname, end="")
+        self.cache = cache
+        self.cacheKey = cacheKey
+        # samples run locally or through a queue shared with other nodes
+        if sampleExecutor is None:
+            sampleExecutor = executor.LocalExecutor()
+        self.executor = sampleExecutor
+
+        # threading.Event set when the outcome of the task becomes useless;
+        # such tasks print their progress in one piece, at the end
+        self.cancelled = cancelled
+        self.output = ""
+
+        # threading.Semaphore counting the processes left to the tasks tested
+        # at once, so that they never run more than maxNbPROC samples together
+        self.slots = slots
+
+        self.write(header + self.dirname)
+
+    def write(self, msg):
+        if self.cancelled is None:
+            print(msg, end="", flush=True)
+        else:
+            self.output += msg
+
+    def isCancelled(self):
+        return self.cancelled is not None and self.cancelled.is_set()
+
+    def acquireSlot(self, blocking):
+        """Reserve a process for one sample. When BLOCKING, wait for one
+        unless the task is cancelled meanwhile. Return False if none is
+        reserved."""
+        if self.slots is None:
+            return True
+        if not blocking:
+            return self.slots.acquire(blocking=False)
+        while not self.slots.acquire(timeout=0.01):
+            if self.isCancelled():
+                return False
+        return True
+
+    def releaseSlot(self):
+        if self.slots is not None:
+            self.slots.release()
 
     def nameDir(self, i):
         return os.path.join(self.dirname, "dd.run%i" % (i+1))
@@ -68,9 +117,11 @@ class InterflopTask:
     def runOneSample(self, i):
         rundir = self.nameDir(i)
 
-        self.subProcessRun[i] = runCmdAsync([self.runCmd, rundir],
-                                            os.path.join(rundir, "dd.run"),
-                                            self.runEnv)
+        fname = os.path.join(rundir, "dd.run")
+        self.subProcessRun[i] = self.executor.submit([self.runCmd, rundir],
+                                                     self.runEnv,
+                                                     stdout=fname + ".out",
+                                                     stderr=fname + ".err")
 
     def cmpOneSample(self, i):
         rundir = self.nameDir(i)
@@ -81,8 +132,10 @@ class InterflopTask:
 
         with open(os.path.join(self.dirname, rundir, "returnVal"), "w") as f:
             f.write(str(retval))
+        if self.cache is not None:
+            self.cache.add(self.cacheKey, i, retval)
         if retval != 0:
-            print("FAIL(%d)" % i)
+            self.write("FAIL(%d)\n" % i)
             return self.FAIL
         else:
             return self.PASS
@@ -95,23 +148,41 @@ class InterflopTask:
             self.dirname) if runDir.startswith("dd.run")]
         done = []
         for runDir in listOfDir:
-            status = int(
-                (open(os.path.join(self.dirname, runDir, "returnVal")).readline()))
+            returnVal = os.path.join(self.dirname, runDir, "returnVal")
+            if not os.path.exists(returnVal):
+                # sample interrupted in a previous session
+                shutil.rmtree(os.path.join(self.dirname, runDir))
+                continue
+            status = int((open(returnVal).readline()))
             if status != 0:
                 return None
             done += [runDir]
 
         res = [x for x in range(nbRun) if not ('dd.run'+str(x+1)) in done]
+
+        # samples known from the persistent cache
+        if self.cache is not None:
+            known = self.cache.get(self.cacheKey)
+            if any(known[x] != 0 for x in res if x in known):
+                return None
+            res = [x for x in res if x not in known]
+
         return res
 
     def run(self):
+        returnVal = self.runTask()
+        if self.cancelled is not None:
+            print(self.output, end="", flush=True)
+        return returnVal
+
+    def runTask(self):
         workToDo = self.sampleToComputeToGetFailure(self.nbRun)
         if workToDo is None:
-            print(" --(cache) -> FAIL")
+            self.write(" --(cache) -> FAIL\n")
             return self.FAIL
 
         if len(workToDo) != 0:
-            print(" --( run )-> ", end="", flush=True)
+            self.write(" --( run )-> ")
 
             if self.maxNbPROC is None:
                 returnVal = self.runSeq(workToDo)
@@ -119,35 +190,81 @@ class InterflopTask:
                 returnVal = self.runPar(workToDo)
 
             if(returnVal == self.PASS):
-                print("PASS(+" + str(len(workToDo))+"->"+str(self.nbRun)+")")
+                self.write("PASS(+" + str(len(workToDo))+"->"+str(self.nbRun)+")\n")
+            if(returnVal == self.UNRESOLVED):
+                self.write("CANCELLED\n")
             return returnVal
-        print(" --(cache)-> PASS("+str(self.nbRun)+")")
+        self.write(" --(cache)-> PASS("+str(self.nbRun)+")\n")
         return self.PASS
 
     def runSeq(self, workToDo):
 
         for run in workToDo:
+            if not self.acquireSlot(blocking=True):
+                return self.UNRESOLVED
             self.mkdir(run)
             self.runOneSample(run)
+            if self.waitSamples([run]) is None:
+                return self.UNRESOLVED
             retVal = self.cmpOneSample(run)
 
-            if retVal == "FAIL":
+            if retVal == self.FAIL:
                 return self.FAIL
         return self.PASS
 
     def runPar(self, workToDo):
 
-        for run in workToDo:
-            self.mkdir(run)
-            self.runOneSample(run)
-        for run in workToDo:
-            retVal = self.cmpOneSample(run)
-
-            if retVal == "FAIL":
-                return self.FAIL
+        # start the samples as processes are free, and compare them as soon as
+        # they complete: the first failure decides, and the samples still
+        # running are useless. Wait for a free process only when none of the
+        # samples of the task runs, since these may hold the missing ones.
+        waiting = list(workToDo)
+        running = []
+        while len(waiting) + len(running) != 0:
+            while len(waiting) != 0 and \
+                    self.acquireSlot(blocking=len(running) == 0):
+                run = waiting.pop(0)
+                self.mkdir(run)
+                self.runOneSample(run)
+                running.append(run)
+
+            finished = self.waitSamples(running)
+            if finished is None:
+                return self.UNRESOLVED
+
+            running = [run for run in running if run not in finished]
+            for run in finished:
+                retVal = self.cmpOneSample(run)
+
+                if retVal == self.FAIL:
+                    self.cancel(running)
+                    return self.FAIL
 
         return self.PASS
 
+    def waitSamples(self, runs):
+        """Wait for samples of RUNS to complete and return them. If the task
+        is cancelled meanwhile, kill RUNS and return None."""
+        while True:
+            if self.isCancelled():
+                self.cancel(runs)
+                return None
+            finished = [run for run in runs
+                        if self.subProcessRun[run].poll() is not None]
+            if len(finished) != 0:
+                for run in finished:
+                    self.releaseSlot()
+                return finished
+            time.sleep(0.01)
+
+    def cancel(self, runs):
+        """Kill the samples of RUNS and remove their directories"""
+        for run in runs:
+            self.subProcessRun[run].kill()
+            self.subProcessRun[run].wait()
+            self.releaseSlot()
+            self.rmdir(run)
+
 
 def md5Name(deltas):
     copyDeltas = copy.copy(deltas)
@@ -186,6 +303,44 @@ class DDStoch(DD.DD):
         self.mergeList()
         self.checkReference()
 
+        self.cache_ = None
+        if self.config_.get_cacheDir() is not None:
+            self.cache_ = dd_cache.SampleCache(self.config_.get_cacheDir(),
+                                               self.cacheContext())
+
+        self.executor_ = executor.get_executor(self.config_.get_queueDir())
+
+        # processes shared by the sets tested at once
+        self.slots_ = None
+        if self.config_.get_maxNbPROC() is not None:
+            self.slots_ = threading.BoundedSemaphore(self.config_.get_maxNbPROC())
+
+    def referenceObjects(self):
+        """Executable and libraries mapped by the reference run, if recorded"""
+        try:
+            with open(os.path.join(self.ref_, "dd.objects"), "r") as f:
+                objects = [line.rstrip("\n") for line in f]
+        except FileNotFoundError:
+            return []
+        return sorted(set(o for o in objects if os.path.isfile(o)))
+
+    def cacheContext(self):
+        """Hash of everything, besides the deltas, that a sample depends on"""
+        # a binary rebuilt with the same symbols and lines is only told apart
+        # by its content
+        objects = self.referenceObjects() + self.config_.get_cacheDeps()
+        if len(objects) == 0:
+            print("Error: the binaries of the reference run are unknown, set "
+                  + "INTERFLOP_DD_CACHE_DEPS to use INTERFLOP_DD_CACHE")
+            failure()
+        files = [self.run_, self.compare_] + objects
+        # the reference deltas (addresses and lines) change with the binary
+        deltas = sorted(self.getDelta0())
+        env = ["%s=%s" % (var, os.environ[var]) for var in sorted(os.environ)
+               if var.startswith("VFC_")]
+        return dd_cache.hashContext(files,
+                                    [self.getDeltaFileName()] + deltas + env)
+
     def mergeList(self):
         """merge the file name.$PID into a uniq file called name """
         dirname = self.ref_
@@ -543,9 +698,45 @@ class DDStoch(DD.DD):
                 for line in excludes:
                     f.write(line)
 
-    def _test(self, deltas, nbRun=None):
+    def test_first_fail(self, cs, nbRun, trying=None):
+        """Test the configurations of CS speculatively, up to
+        INTERFLOP_DD_SPECULATE at once.  When a configuration fails, the
+        tests of the following ones are cancelled, since the sequential
+        algorithm would not have run them: the result is the same.  The
+        message of TRYING is printed with the output of its test."""
+        nbSpeculate = self.config_.get_nbSpeculate()
+        if nbSpeculate <= 1 or len(cs) <= 1:
+            return DD.DD.test_first_fail(self, cs, nbRun, trying)
+
+        events = [threading.Event() for c in cs]
+        headers = ["" if trying is None else trying(c) + "\n" for c in cs]
+        first = len(cs)
+        with ThreadPoolExecutor(max_workers=nbSpeculate) as pool:
+            futures = {pool.submit(self._test, cs[i], nbRun, events[i],
+                                   headers[i]): i
+                       for i in range(len(cs))}
+            pending = set(futures)
+            while len(pending) != 0:
+                done, pending = wait(pending, return_when=FIRST_COMPLETED)
+                for future in done:
+                    i = futures[future]
+                    if not future.cancelled() and future.result() == self.FAIL \
+                       and i < first:
+                        first = i
+                        for j in range(i + 1, len(cs)):
+                            events[j].set()
+                # only the configurations before the first failure matter
+                for future in pending:
+                    if futures[future] > first:
+                        future.cancel()
+                pending = set(f for f in pending if futures[f] < first)
+
+        return first if first < len(cs) else None
+
+    def _test(self, deltas, nbRun=None, cancelled=None, header=""):
         if nbRun is None:
             nbRun = self.config_.get_nbRUN()
+        nbRun = self.config_.get_nbRUNToPass(nbRun)
 
         dirname = os.path.join(self.prefix_, md5Name(deltas))
         if not os.path.exists(dirname):
@@ -553,7 +744,13 @@ class DDStoch(DD.DD):
             self.genExcludeIncludeFile(
                 dirname, deltas, include=True, exclude=True)
 
+        cacheKey = None
+        if self.cache_ is not None:
+            cacheKey = self.cache_.key(deltas)
+
         vT = InterflopTask(dirname, self.ref_, self.run_, self.compare_,
-                           nbRun, self.config_.get_maxNbPROC(), self.sampleRunEnv(dirname))
+                           nbRun, self.config_.get_maxNbPROC(), self.sampleRunEnv(dirname),
+                           self.cache_, cacheKey, cancelled, self.executor_,
+                           self.slots_, header)
 
         return vT.run()
@@ -0,0 +1,75 @@
+import hashlib
+import os
+
+
+class SampleCache:
+    """Persistent cache of the sample outcomes of delta-debug configurations.
+
+    The cache is content-addressed: the key of a configuration is a hash of
+    its sorted deltas and of the session context (run and compare scripts,
+    reference deltas, which change with the binary, noise backend and seed
+    options, and any additional dependency given by the user). Results
+    obtained with another binary or another setup are thus never reused.
+
+    Each configuration has its own file in the cache directory, where the
+    outcome of every sample is appended as soon as it is known, so that an
+    interrupted search resumes from the last completed sample. Samples are
+    stored individually, so they are shared between searches using different
+    numbers of samples per configuration.
+    """
+
+    def __init__(self, dirname, context):
+        self.dirname = dirname
+        self.context = context
+        os.makedirs(dirname, exist_ok=True)
+
+    def key(self, deltas):
+        h = hashlib.sha256(self.context.encode("utf-8"))
+        for delta in sorted(deltas):
+            h.update(b"\0")
+            h.update(delta.encode("utf-8"))
+        return h.hexdigest()
+
+    def path(self, key):
+        return os.path.join(self.dirname, key[:2], key)
+
+    def get(self, key):
+        """Return the known outcomes of KEY as a {sample: returnVal} dict"""
+        outcomes = {}
+        try:
+            with open(self.path(key), "r") as f:
+                for line in f:
+                    # a line truncated by an interruption is ignored
+                    if not line.endswith("\n"):
+                        break
+                    sample, retval = line.split()
+                    outcomes[int(sample)] = int(retval)
+        except FileNotFoundError:
+            pass
+        return outcomes
+
+    def add(self, key, sample, retval):
+        """Record the outcome RETVAL of SAMPLE for KEY"""
+        path = self.path(key)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        # a single short write in append mode, so concurrent writers do not
+        # interleave their records
+        fd = os.open(path, os.O_WRONLY | os.O_APPEND | os.O_CREAT, 0o644)
+        try:
+            os.write(fd, ("%d %d\n" % (sample, retval)).encode("utf-8"))
+        finally:
+            os.close(fd)
+
+
+def hashContext(files, strings):
+    """Hash the content of FILES and STRINGS into a cache context"""
+    h = hashlib.sha256()
+    for fname in files:
+        h.update(fname.encode("utf-8") + b"\0")
+        with open(fname, "rb") as f:
+            for block in iter(lambda: f.read(1 << 20), b""):
+                h.update(block)
+        h.update(b"\0")
+    for string in strings:
+        h.update(string.encode("utf-8") + b"\0")
+    return h.hexdigest()
@@ -16,6 +16,7 @@ class ddConfig:
         self.parseArgv(argv)
         for config_key in self.config_keys:
             self.read_environ(environ, config_key)
+        self.checkEarlyStop()
 
     def defaultValue(self):
         self.nbRUN = 5
@@ -27,6 +28,12 @@ class ddConfig:
         self.splitGranularity = 2
         self.ddSym = False
         self.ddQuiet = False
+        self.confidence = None
+        self.failureRate = None
+        self.cacheDir = None
+        self.cacheDeps = None
+        self.nbSpeculate = 1
+        self.queueDir = None
 
     def parseArgv(self, argv):
         if "-h" in argv or "--help" in argv:
@@ -101,11 +108,48 @@ class ddConfig:
         self.readOneOption("ddSym", "bool", "DD_SYM")
         self.readOneOption("ddQuiet", "bool", "DD_QUIET")
 
+        self.readOneOption("nbSpeculate", "int", "DD_SPECULATE")
+        self.readOneOption("queueDir", "string", "DD_QUEUE")
+        self.readOneOption("cacheDir", "string", "DD_CACHE")
+        self.readOneOption("cacheDeps", "string", "DD_CACHE_DEPS")
+
+        self.readOneOption("confidence", "float", "DD_CONFIDENCE")
+        self.readOneOption("failureRate", "float", "DD_FAILURE_RATE")
+
+    def checkEarlyStop(self):
+        """DD_CONFIDENCE and DD_FAILURE_RATE only make sense together, and
+        get_nbRUNToPass takes the logarithm of their complement to 1"""
+        PREFIX = self.config_keys[-1]
+        if (self.confidence is None) != (self.failureRate is None):
+            print(
+                "Error : "
+                + PREFIX
+                + "_DD_CONFIDENCE and "
+                + PREFIX
+                + "_DD_FAILURE_RATE should be set together"
+            )
+            self.failure()
+        for key_name, value in [
+            ("DD_CONFIDENCE", self.confidence),
+            ("DD_FAILURE_RATE", self.failureRate),
+        ]:
+            if value is not None and not 0 < value < 1:
+                print("Error : " + PREFIX + "_" + key_name + " should be in ]0,1[")
+                self.failure()
+
     def readOneOption(self, attribut, conv_type, key_name, acceptedValue=None):
         value = False
         try:
             if conv_type == "int":
                 value = int(self.environ[self.PREFIX + "_" + key_name])
+            elif conv_type == "float":
+                try:
+                    value = float(self.environ[self.PREFIX + "_" + key_name])
+                except ValueError:
+                    print(
+                        "Error : " + self.PREFIX + "_" + key_name + " should be a float"
+                    )
+                    self.failure()
             else:
                 value = self.environ[self.PREFIX + "_" + key_name]
 
@@ -167,6 +211,40 @@ class ddConfig:
     def get_quiet(self):
         return self.ddQuiet
 
+    def get_nbSpeculate(self):
+        return self.nbSpeculate
+
+    def get_queueDir(self):
+        if self.queueDir is None:
+            return None
+        return os.path.abspath(self.queueDir)
+
+    def get_cacheDir(self):
+        if self.cacheDir is None:
+            return None
+        return os.path.abspath(self.cacheDir)
+
+    def get_cacheDeps(self):
+        if self.cacheDeps is None:
+            return []
+        return [os.path.abspath(f) for f in self.cacheDeps.split(":") if f != ""]
+
+    def get_nbRUNToPass(self, nbRun):
+        """Number of passing samples after which a configuration passes.
+
+        Sampling stops at the first failing sample, which is conclusive. With
+        DD_CONFIDENCE and DD_FAILURE_RATE, it also stops once the hypothesis
+        "the configuration fails with probability >= DD_FAILURE_RATE" is
+        rejected at the DD_CONFIDENCE level: k passing samples happen with
+        probability <= (1 - DD_FAILURE_RATE)^k under this hypothesis.
+        """
+        if self.confidence is None or self.failureRate is None:
+            return nbRun
+        needed = math.ceil(
+            math.log(1 - self.confidence) / math.log(1 - self.failureRate)
+        )
+        return min(nbRun, needed)
+
     def get_rddMinTab(self):
         rddMinTab = None
         if self.param_rddmin_tab == "exp":
@@ -202,5 +280,11 @@ class ddConfig:
         PREFIXENV_DD_DICHO_GRANULARITY : int
         PREFIXENV_DD_QUIET : set or not (default not)
         PREFIXENV_DD_SYM : set or not (default not)
+        PREFIXENV_DD_CONFIDENCE : float in ]0,1[ (default None)
+        PREFIXENV_DD_FAILURE_RATE : float in ]0,1[ (default None)
+        PREFIXENV_DD_SPECULATE : int (default 1)
+        PREFIXENV_DD_QUEUE : directory of a job queue shared with vfc_worker processes (default None)
+        PREFIXENV_DD_CACHE : directory of the persistent sample cache (default None)
+        PREFIXENV_DD_CACHE_DEPS : ':'-separated files hashed in the cache keys, besides the binaries of the reference run
         """
         return doc.replace("PREFIXENV_", PREFIX + "_")
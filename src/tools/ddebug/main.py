@@ -14,6 +14,7 @@ class DDline(DD_stoch.DDStoch):
         return {
             "VFC_BACKENDS": "libinterflop_ieee.so",
             "VFC_DDEBUG_GEN": os.path.join(self.ref_, "dd.line.%%p"),
+            "VFC_DDEBUG_GEN_OBJECTS": os.path.join(self.ref_, "dd.objects"),
         }
 
     def isFileValidToMerge(self, name):
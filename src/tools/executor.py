@@ -0,0 +1,420 @@
+##############################################################################\
+#                                                                           #\
+#  This file is part of the Verificarlo project,                            #\
+#  under the Apache License v2.0 with LLVM Exceptions.                      #\
+#  SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception.                 #\
+#  See https://llvm.org/LICENSE.txt for license information.                #\
+#                                                                           #\
+#                                                                           #\
+#  Copyright (c) 2019-2026                                                  #\
+#     Verificarlo Contributors                                              #\
+#                                                                           #\
+#############################################################################
+
+# Execution backends for the samples of vfc_ddebug and vfc_ci.
+#
+# A sample is a command executed with a few additional environment variables,
+# its outputs being redirected to files. Executors start samples and return
+# handles with the part of the subprocess.Popen interface used by the tools:
+# poll(), wait(), kill() and returncode.
+#
+# - LocalExecutor runs the samples as child processes of the tool.
+# - QueueExecutor writes the samples as jobs in a directory of a shared
+#   filesystem. Worker processes, started on any node mounting the directory
+#   (vfc_worker DIRECTORY), claim the jobs with lock files and run them, so
+#   that several machines share the samples of a single session.
+#
+# Each job of a queue is a set of files named after the job id:
+# - <id>.job: the command, environment, working directory and outputs (JSON),
+# - <id>.lock: created (O_EXCL) by the worker claiming the job, with a token
+#   unique to this claim, and touched periodically while the job runs,
+# - <id>.cancel: created by the submitter to kill the job,
+# - <id>.status: the exit code of the job and the token of the worker.
+# When a lock goes stale, the submitter removes it and the job is claimed
+# again. The previous worker, if it was only stalled, finds another token in
+# the lock: it kills its run and does not write the status. A status written
+# anyway, racing with the check, does not match the lock and is ignored.
+# Files are written under a temporary name and renamed, so that readers never
+# see them partially written. The submitter removes the files of a job once
+# its status is known.
+
+import argparse
+import json
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import time
+import uuid
+
+# Magic numbers
+poll_interval = 0.05  # Seconds between two checks of the queue
+heartbeat_interval = 5  # Seconds between two touches of the lock of a job
+# A job whose lock is not touched for this long (as seen by the submitter,
+# to be immune to clock skew between nodes) is considered lost and requeued
+stale_timeout = 60
+
+# Exit code of the jobs cancelled before running (as if killed by SIGKILL)
+killed_returncode = -9
+
+##########################################################################
+
+# Environment forwarded to the jobs
+
+
+def forwarded_environ(env=None):
+    """
+    Environment variables to set for a job: the Verificarlo settings of the
+    submitter (VFC_*, INTERFLOP_*) and ENV. The rest of the environment of a
+    queued job is the one of the worker running it.
+    """
+
+    forwarded = {
+        var: value
+        for var, value in os.environ.items()
+        if var.startswith("VFC_") or var.startswith("INTERFLOP_")
+    }
+    if env is not None:
+        forwarded.update(env)
+    return forwarded
+
+
+def write_atomic(path, content):
+    tmp = "%s.tmp-%s-%d" % (path, socket.gethostname(), os.getpid())
+    with open(tmp, "w") as f:
+        f.write(content)
+    os.rename(tmp, path)
+
+
+def remove_quietly(path):
+    try:
+        os.remove(path)
+    except FileNotFoundError:
+        pass
+
+
+def lock_token(path):
+    """Token of the claim of the lock PATH, None if the job is not claimed"""
+
+    try:
+        with open(path) as f:
+            fields = f.read().split()
+    except FileNotFoundError:
+        return None
+    return fields[-1] if fields else None
+
+
+def start_process(cmd, env, cwd, stdout, stderr):
+    """Start CMD with ENV added to the current environment"""
+
+    fout = open(stdout, "w") if stdout is not None else None
+    ferr = open(stderr, "w") if stderr is not None else None
+    try:
+        return subprocess.Popen(
+            cmd,
+            env=dict(os.environ, **env),
+            cwd=cwd,
+            stdout=fout,
+            stderr=ferr,
+        )
+    finally:
+        for f in [fout, ferr]:
+            if f is not None:
+                f.close()
+
+
+##########################################################################
+
+# Local execution
+
+
+class LocalExecutor:
+    """Run the samples as child processes"""
+
+    # Where to create the files exchanged with the samples (None for the
+    # default temporary directory)
+    scratch_directory = None
+
+    def submit(self, cmd, env=None, cwd=None, stdout=None, stderr=None, cpus=None):
+        """
+        Start CMD with ENV added to the environment, in the directory CWD,
+        redirecting its outputs to the STDOUT and STDERR files. The process is
+        pinned to the CPUS set, if any.
+        """
+
+        # The affinity is set by taskset in the child rather than with a
+        # preexec_fn, which is not safe in the threads of vfc_ddebug
+        taskset = shutil.which("taskset") if cpus is not None else None
+        if taskset is not None:
+            cpu_list = ",".join(str(cpu) for cpu in sorted(cpus))
+            cmd = [taskset, "--cpu-list", cpu_list] + list(cmd)
+
+        p = start_process(cmd, env if env is not None else {}, cwd, stdout, stderr)
+        if cpus is not None and taskset is None:
+            try:
+                os.sched_setaffinity(p.pid, cpus)
+            except ProcessLookupError:
+                pass
+        return p
+
+
+##########################################################################
+
+# Shared filesystem queue
+
+
+class QueuedJob:
+    """Handle of a job submitted to a queue"""
+
+    def __init__(self, directory, job_id):
+        self.directory = directory
+        self.job_id = job_id
+        self.returncode = None
+
+        # Last modification of the lock seen, and when it was seen
+        self.lock_mtime = None
+        self.lock_seen = time.monotonic()
+
+    def path(self, extension):
+        return os.path.join(self.directory, self.job_id + extension)
+
+    def cleanup(self):
+        for extension in [".job", ".lock", ".status", ".cancel"]:
+            remove_quietly(self.path(extension))
+
+    def check_lock(self):
+        """Requeue the job if its worker stopped touching the lock"""
+
+        try:
+            mtime = os.stat(self.path(".lock")).st_mtime_ns
+        except FileNotFoundError:
+            self.lock_mtime = None
+            return
+
+        now = time.monotonic()
+        if mtime != self.lock_mtime:
+            self.lock_mtime = mtime
+            self.lock_seen = now
+        elif now - self.lock_seen > stale_timeout:
+            print(
+                "Warning [executor]: The worker of job %s stopped responding, "
+                "the job is requeued." % self.job_id,
+                file=sys.stderr,
+            )
+            remove_quietly(self.path(".lock"))
+            self.lock_mtime = None
+
+    def poll(self):
+        if self.returncode is not None:
+            return self.returncode
+
+        try:
+            with open(self.path(".status")) as f:
+                returncode, token = f.read().split()
+            returncode = int(returncode)
+        except (FileNotFoundError, ValueError):
+            self.check_lock()
+            return None
+
+        if token != lock_token(self.path(".lock")):
+            # Written by a worker whose lock went stale: the job was requeued,
+            # its new worker overwrites the status
+            self.check_lock()
+            return None
+
+        self.returncode = returncode
+
+        self.cleanup()
+        return self.returncode
+
+    def wait(self, timeout=None):
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while self.poll() is None:
+            if deadline is not None and time.monotonic() > deadline:
+                raise subprocess.TimeoutExpired(self.job_id, timeout)
+            time.sleep(poll_interval)
+        return self.returncode
+
+    def kill(self):
+        if self.returncode is not None:
+            return
+
+        write_atomic(self.path(".cancel"), "")
+
+        # Claim the job ourselves if no worker did, so that it never runs
+        try:
+            fd = os.open(self.path(".lock"), os.O_WRONLY | os.O_CREAT | os.O_EXCL)
+        except FileExistsError:
+            # The worker kills the job and writes its status
+            return
+        os.close(fd)
+        self.returncode = killed_returncode
+        self.cleanup()
+
+
+class QueueExecutor:
+    """Submit the samples to the workers of a shared directory"""
+
+    def __init__(self, directory):
+        self.directory = os.path.abspath(directory)
+        os.makedirs(self.directory, exist_ok=True)
+        self.scratch_directory = self.directory
+
+    def submit(self, cmd, env=None, cwd=None, stdout=None, stderr=None, cpus=None):
+        """
+        Same as LocalExecutor.submit. Paths are made absolute, as the workers
+        have to see the same filesystem. CPUS is ignored, the workers running
+        on their own share of the machines.
+        """
+
+        cwd = os.path.abspath(cwd if cwd is not None else os.getcwd())
+        job = {
+            "cmd": list(cmd),
+            "env": forwarded_environ(env),
+            "cwd": cwd,
+            "stdout": os.path.join(cwd, stdout) if stdout is not None else None,
+            "stderr": os.path.join(cwd, stderr) if stderr is not None else None,
+        }
+
+        # Ids sort by submission time, so that workers take the oldest jobs
+        job_id = "%020d-%s" % (time.time_ns(), uuid.uuid4().hex)
+        handle = QueuedJob(self.directory, job_id)
+        write_atomic(handle.path(".job"), json.dumps(job))
+        return handle
+
+
+def get_executor(queue_directory=None):
+    """The queue of QUEUE_DIRECTORY if given, local execution otherwise"""
+
+    if queue_directory is None:
+        return LocalExecutor()
+    return QueueExecutor(queue_directory)
+
+
+##########################################################################
+
+# Worker
+
+
+def claim_job(directory):
+    """
+    Lock the oldest job of the queue, and return its id and the token of the
+    claim, or (None, None) if there is no job to claim
+    """
+
+    for name in sorted(os.listdir(directory)):
+        if not name.endswith(".job"):
+            continue
+        job_id = name[: -len(".job")]
+        try:
+            fd = os.open(
+                os.path.join(directory, job_id + ".lock"),
+                os.O_WRONLY | os.O_CREAT | os.O_EXCL,
+            )
+        except FileExistsError:
+            continue
+        token = uuid.uuid4().hex
+        owner = "%s %d %s\n" % (socket.gethostname(), os.getpid(), token)
+        os.write(fd, owner.encode())
+        os.close(fd)
+        return job_id, token
+
+    return None, None
+
+
+def run_job(directory, job_id, token):
+    """
+    Run a job claimed with TOKEN until it ends or is cancelled, and write its
+    status, unless the job was requeued in the meantime
+    """
+
+    handle = QueuedJob(directory, job_id)
+    try:
+        with open(handle.path(".job")) as f:
+            job = json.load(f)
+    except FileNotFoundError:
+        # Cancelled and cleaned up in the meantime
+        remove_quietly(handle.path(".lock"))
+        return
+
+    returncode = killed_returncode
+    if not os.path.exists(handle.path(".cancel")):
+        try:
+            p = start_process(
+                job["cmd"], job["env"], job["cwd"], job["stdout"], job["stderr"]
+            )
+        except OSError as e:
+            print("Error [executor]: %s" % e, file=sys.stderr)
+            returncode = 127
+        else:
+            heartbeat = time.monotonic()
+            while p.poll() is None:
+                time.sleep(poll_interval)
+                if os.path.exists(handle.path(".cancel")):
+                    p.kill()
+                    p.wait()
+                    break
+                if time.monotonic() - heartbeat > heartbeat_interval:
+                    heartbeat = time.monotonic()
+                    if lock_token(handle.path(".lock")) != token:
+                        # Requeued, another worker runs the job
+                        p.kill()
+                        p.wait()
+                        return
+                    try:
+                        os.utime(handle.path(".lock"))
+                    except FileNotFoundError:
+                        pass
+            returncode = p.returncode
+
+    if lock_token(handle.path(".lock")) != token:
+        return
+    write_atomic(handle.path(".status"), "%d %s" % (returncode, token))
+
+
+def worker(directory, idle_timeout=None):
+    """Run the jobs of the queue of DIRECTORY, one at a time"""
+
+    os.makedirs(directory, exist_ok=True)
+    idle_since = time.monotonic()
+    while True:
+        job_id, token = claim_job(directory)
+        if job_id is None:
+            if (
+                idle_timeout is not None
+                and time.monotonic() - idle_since > idle_timeout
+            ):
+                return
+            time.sleep(poll_interval)
+            continue
+
+        run_job(directory, job_id, token)
+        idle_since = time.monotonic()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="""
+        Run the samples queued in a shared directory by vfc_ddebug
+        (INTERFLOP_DD_QUEUE) or vfc_ci test (--queue). Start one worker per
+        sample to run at once, on any node that mounts the directory.
+        """)
+    parser.add_argument("directory", help="The queue directory.")
+    parser.add_argument(
+        "--idle-timeout",
+        help="""
+        Stop after waiting this many seconds for a job (run forever by
+        default).
+        """,
+        type=float,
+    )
+    args = parser.parse_args()
+
+    try:
+        worker(args.directory, args.idle_timeout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -22,51 +22,68 @@
 /************************************************************
  *                       Hash Functions                     *
  ************************************************************/
-vfc_hashmap_t _vfc_func_map;
-
-// Add a function in the hash table
+// Storage of the function info, released at once when quitting
+vfc_arena_t _vfc_func_arena;
+// Function names -> dense IDs
+vfc_strintern_t _vfc_func_names;
+// Name IDs -> function info
+vfc_swisstable_t _vfc_func_map;
+// Address of the name passed by a call site -> function info, so that the
+// name is only hashed the first time a call site is reached
+vfc_swisstable_t _vfc_func_sites;
+
+// Add a function in the hash table, returns the function stored in the table
+// if another thread added it first
 interflop_function_info_t *
 vfc_func_table_add(interflop_function_info_t function) {
-  size_t key = vfc_hashmap_str_function(function.id);
+  ISize_t key = vfc_strintern_id(_vfc_func_names, function.id);
 
   interflop_function_info_t *ptr =
-      (interflop_function_info_t *)malloc(sizeof(interflop_function_info_t));
+      (interflop_function_info_t *)vfc_arena_alloc(
+          _vfc_func_arena, sizeof(interflop_function_info_t));
 
   (*ptr) = function;
+  ptr->uid = key + 1;
 
-  vfc_hashmap_insert(_vfc_func_map, key, (void *)ptr);
-
-  return ptr;
+  // if another thread won, ptr stays unused in the arena
+  return vfc_swisstable_insert_if_absent(_vfc_func_map, key, (void *)ptr);
 }
 
 // Search a function in the hash table
 interflop_function_info_t *vfc_func_table_get(const char *id) {
-  size_t key = vfc_hashmap_str_function(id);
+  ISize_t key = vfc_strintern_lookup(_vfc_func_names, id);
 
-  return vfc_hashmap_get(_vfc_func_map, key);
+  if (key == VFC_STRINTERN_NONE)
+    return NULL;
+
+  return vfc_swisstable_get(_vfc_func_map, key);
 }
 
 // Print the table
 void _vfc_func_table_print(FILE *f) {
-  for (size_t ii = 0; ii < _vfc_func_map->capacity; ii++) {
-    if (get_value_at(_vfc_func_map->items, ii) != 0 &&
-        get_value_at(_vfc_func_map->items, ii) != 0) {
-      interflop_function_info_t *function =
-          (interflop_function_info_t *)get_value_at(_vfc_func_map->items, ii);
-      interflop_fprintf(f, "%s\t%hd\t%hd\t%hu\t%hu\n", function->id,
-                        function->isLibraryFunction,
-                        function->isIntrinsicFunction, function->useFloat,
-                        function->useDouble);
-    }
+  size_t cursor = 0;
+  void *value;
+  while (vfc_swisstable_next(_vfc_func_map, &cursor, NULL, &value)) {
+    interflop_function_info_t *function = (interflop_function_info_t *)value;
+    interflop_fprintf(f, "%s\t%hd\t%hd\t%hu\t%hu\n", function->id,
+                      function->isLibraryFunction,
+                      function->isIntrinsicFunction, function->useFloat,
+                      function->useDouble);
   }
 }
 
-void vfc_func_table_init() { _vfc_func_map = vfc_hashmap_create(); }
+void vfc_func_table_init() {
+  _vfc_func_arena = vfc_arena_create();
+  _vfc_func_names = vfc_strintern_create();
+  _vfc_func_map = vfc_swisstable_create();
+  _vfc_func_sites = vfc_swisstable_create();
+}
 
 void vfc_func_table_quit() {
-  vfc_hashmap_free(_vfc_func_map);
-
-  vfc_hashmap_destroy(_vfc_func_map);
+  vfc_swisstable_destroy(_vfc_func_sites);
+  vfc_swisstable_destroy(_vfc_func_map);
+  vfc_strintern_destroy(_vfc_func_names);
+  vfc_arena_destroy(_vfc_func_arena);
 }
 
 /************************************************************
@@ -123,16 +140,24 @@ void vfc_call_stack_free() {
 void vfc_enter_function(char *func_name, char isLibraryFunction,
                         char isIntrinsicFunction, char useFloat, char useDouble,
                         int n, ...) {
-  // Get a pointer to the function if she is in the table
-  interflop_function_info_t *function = vfc_func_table_get(func_name);
+  // Get a pointer to the function from its call site, then from its name
+  interflop_function_info_t *function =
+      vfc_swisstable_get(_vfc_func_sites, (ISize_t)func_name);
 
   if (function == NULL) {
-    interflop_function_info_t f = {.id = func_name,
-                                   .isLibraryFunction = isLibraryFunction,
-                                   .isIntrinsicFunction = isIntrinsicFunction,
-                                   .useFloat = useFloat,
-                                   .useDouble = useDouble};
-    function = vfc_func_table_add(f);
+    function = vfc_func_table_get(func_name);
+
+    if (function == NULL) {
+      interflop_function_info_t f = {.id = func_name,
+                                     .isLibraryFunction = isLibraryFunction,
+                                     .isIntrinsicFunction =
+                                         isIntrinsicFunction,
+                                     .useFloat = useFloat,
+                                     .useDouble = useDouble};
+      function = vfc_func_table_add(f);
+    }
+
+    vfc_swisstable_insert(_vfc_func_sites, (ISize_t)func_name, function);
   }
 
   vfc_call_stack_push(function);
@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+# Checks the vector hooks and the --mask-reuse option of the bitmask backend
+
+set -e
+
+verificarlo-c -O0 test_vector.c -o test_vector
+
+bitmask() {
+    VFC_BACKENDS="libinterflop_bitmask.so --precision-binary32=10 --precision-binary64=20 $1" \
+        ./test_vector $2
+}
+
+# The deterministic operators must give the same results through the vector
+# hooks as through the scalar hooks
+for operator in zero one; do
+    for mode in ib ob full; do
+        bitmask "--operator=$operator --mode=$mode" vector >out_vector
+        bitmask "--operator=$operator --mode=$mode" scalar >out_scalar
+        if ! diff out_vector out_scalar; then
+            echo "vector and scalar hooks differ with --operator=$operator --mode=$mode"
+            exit 1
+        fi
+    done
+done
+
+# The random operator must perturb the vectors and be reproducible when seeded
+bitmask "--operator=rand" vector >out_vector_1
+bitmask "--operator=rand" vector >out_vector_2
+if diff out_vector_1 out_vector_2 >/dev/null; then
+    echo "vector hooks are not perturbed by the random operator"
+    exit 1
+fi
+for reuse in 1 3; do
+    bitmask "--operator=rand --seed=42 --mask-reuse=$reuse" vector >out_vector_1
+    bitmask "--operator=rand --seed=42 --mask-reuse=$reuse" vector >out_vector_2
+    if ! diff out_vector_1 out_vector_2; then
+        echo "vector hooks are not reproducible with --mask-reuse=$reuse"
+        exit 1
+    fi
+done
+
+# Each random mask serves --mask-reuse draws
+distinct() {
+    bitmask "--operator=rand --mask-reuse=$1" repeat | sort -u | wc -l
+}
+if [[ $(distinct 1) -eq 1 ]]; then
+    echo "random masks are reused without --mask-reuse"
+    exit 1
+fi
+if [[ $(distinct 16) -ne 1 ]]; then
+    echo "random masks are not reused with --mask-reuse=16"
+    exit 1
+fi
+if [[ $(distinct 4) -gt 4 ]]; then
+    echo "random masks are not reused with --mask-reuse=4"
+    exit 1
+fi
+
+if bitmask "--mask-reuse=0" repeat >/dev/null 2>&1; then
+    echo "--mask-reuse=0 is accepted"
+    exit 1
+fi
+
+echo "vector hooks and mask reuse checked"
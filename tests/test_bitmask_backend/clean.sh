@@ -1,3 +1,3 @@
 #!/bin/bash
 
-rm -Rf ./*~ out_bitmask out_mca s_bitmask s_mca test_{float,double} test.log ./*.ll ./*.o .*.o log compute_sig* check_status.py run_parallel ./tmp.*
+rm -Rf ./*~ test_vector out_vector* out_scalar out_bitmask out_mca s_bitmask s_mca test_{float,double} test.log ./*.ll ./*.o .*.o log compute_sig* check_status.py run_parallel ./tmp.*
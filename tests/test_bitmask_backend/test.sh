@@ -53,6 +53,8 @@ check_executable compute_sig_double
 
 export VFC_BACKENDS_LOGGER=False
 
+./check_vector.sh
+
 # Test operates at different precisions, and different operands.
 # It compares that results are equivalents up to the bit.
 parallel --header : "verificarlo-c --function=operator --verbose -D REAL={type} -D SAMPLES=$SAMPLES -O0 test.c -o test_{type} -lm" ::: type float double
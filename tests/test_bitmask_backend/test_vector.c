@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <string.h>
+
+#define N 4
+#define REPEAT 16
+
+typedef float float4 __attribute__((vector_size(N * sizeof(float))));
+typedef double double4 __attribute__((vector_size(N * sizeof(double))));
+
+/* Prints the results of the four operations on the vectors a and b, computed
+ * either on whole vectors or lane by lane */
+#define COMPUTE(TYPE, VTYPE, VECTOR)                                           \
+  do {                                                                         \
+    VTYPE a, b, r[4];                                                          \
+    for (int i = 0; i < N; i++) {                                              \
+      a[i] = 1 / (TYPE)(i + 3);                                                \
+      b[i] = 1 / (TYPE)(i + 7);                                                \
+    }                                                                          \
+    if (VECTOR) {                                                              \
+      r[0] = a + b;                                                            \
+      r[1] = a - b;                                                            \
+      r[2] = a * b;                                                            \
+      r[3] = a / b;                                                            \
+    } else {                                                                   \
+      for (int i = 0; i < N; i++) {                                            \
+        TYPE x = a[i], y = b[i];                                               \
+        r[0][i] = x + y;                                                       \
+        r[1][i] = x - y;                                                       \
+        r[2][i] = x * y;                                                       \
+        r[3][i] = x / y;                                                       \
+      }                                                                        \
+    }                                                                          \
+    for (int op = 0; op < 4; op++) {                                           \
+      for (int i = 0; i < N; i++) {                                            \
+        printf("%a ", (double)r[op][i]);                                       \
+      }                                                                        \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s vector|scalar|repeat\n", argv[0]);
+    return 1;
+  }
+
+  if (strcmp(argv[1], "repeat") == 0) {
+    /* The same operation, perturbed with successive random masks */
+    double x = 1 / 3.0, y = 1 / 7.0;
+    for (int i = 0; i < REPEAT; i++) {
+      printf("%a\n", x + y);
+    }
+  } else {
+    int vector = strcmp(argv[1], "vector") == 0;
+    COMPUTE(float, float4, vector);
+    COMPUTE(double, double4, vector);
+  }
+
+  return 0;
+}
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ cache scale.h *.o *.o.log *.ll
@@ -0,0 +1 @@
+double f(double x) { return x + 0.1; }
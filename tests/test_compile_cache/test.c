@@ -0,0 +1,5 @@
+#include "scale.h"
+
+static int unused(void) { return 0; }
+
+double scale(double x) { return x * SCALE + 0.1; }
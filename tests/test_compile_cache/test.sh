@@ -0,0 +1,70 @@
+#!/bin/bash
+#
+# Checks the cache of instrumented objects: a hit restores the object of a
+# fresh compilation with its warnings, a change of option, included file or
+# LLVM IR source misses, and the cache is trimmed to VFC_CACHE_MAX_SIZE
+
+set -e
+
+export VFC_CACHE_DIR=$PWD/cache
+rm -rf $VFC_CACHE_DIR
+
+echo "#define SCALE 2.0" >scale.h
+
+# Compiles test.c to $1 and tells if the object was restored from the cache
+compile() {
+    local output=$1
+    shift
+    if verificarlo-c -Wall -c test.c -o $output --show-cmd "$@" 2>$output.log |
+        grep -q "^cp .*$output"; then
+        echo hit
+    else
+        echo miss
+    fi
+}
+
+check() {
+    if [[ $1 != $2 ]]; then
+        echo "$3: expected a cache $2, got a $1"
+        exit 1
+    fi
+}
+
+verificarlo-c -Wall -c test.c -o fresh.o --no-cache
+
+check $(compile miss.o) miss "first compilation"
+check $(compile hit.o) hit "same compilation"
+if ! cmp fresh.o hit.o; then
+    echo "the restored object differs from a fresh compilation"
+    exit 1
+fi
+if ! grep -q "Wunused-function" hit.o.log; then
+    echo "the warnings are not replayed on a hit"
+    cat hit.o.log
+    exit 1
+fi
+
+check $(compile option.o -DSCALE=3.0) miss "changed option"
+echo "#define SCALE 4.0" >scale.h
+check $(compile header.o) miss "changed included file"
+check $(compile header_hit.o) hit "same included file"
+
+# LLVM IR sources are not preprocessed, they must not share an entry
+verificarlo-c -S -emit-llvm one.c -o one.ll
+verificarlo-c -S -emit-llvm two.c -o two.ll
+verificarlo-c -c one.ll -o one.o
+verificarlo-c -c two.ll -o two.o
+if cmp -s one.o two.o; then
+    echo "two LLVM IR sources share the same cache entry"
+    exit 1
+fi
+
+# Only the last object fits
+VFC_CACHE_MAX_SIZE=1 verificarlo-c -c test.c -o trim.o -DSCALE=5.0
+objects=$(find $VFC_CACHE_DIR/objects -name "*.o" | wc -l)
+if [[ $objects != 1 ]]; then
+    echo "$objects objects left in the cache instead of 1"
+    exit 1
+fi
+
+echo "test passed"
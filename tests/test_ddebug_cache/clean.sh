@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ archimedes cache dd.line dd.log runs.log first second *.o .*.o
@@ -0,0 +1,63 @@
+#!/bin/bash
+#
+# Checks that the sample cache (INTERFLOP_DD_CACHE) is reused by a second
+# search, and invalidated when the binary or the VFC_* environment changes
+
+set -e
+
+export VFC_BACKENDS_LOGGER=False
+export VFC_BACKENDS="libinterflop_mca.so -m mca --precision-binary64=53 --seed=42"
+export INTERFLOP_DD_NRUNS=5
+export INTERFLOP_DD_CACHE=$PWD/cache
+
+./clean.sh
+verificarlo-c --ddebug -O0 -g archimedes.c -o archimedes -lm --inst-fma
+
+# Runs a search and sets runs to the number of runs of the program, the
+# reference run included
+search() {
+    rm -rf dd.line runs.log
+    vfc_ddebug ddRun ddCmp >dd.log
+    runs=$(wc -l <runs.log)
+}
+
+check_runs() {
+    if [[ $1 != $runs ]]; then
+        echo "$2: $runs runs instead of $1"
+        exit 1
+    fi
+}
+
+check_samples() {
+    if [[ $runs -le 1 ]]; then
+        echo "$1: the samples were not run"
+        exit 1
+    fi
+}
+
+search
+check_samples "first search"
+sort dd.line/rddmin-cmp/dd.line.exclude >first
+
+# Every sample is known, only the reference run remains
+search
+check_runs 1 "second search"
+sort dd.line/rddmin-cmp/dd.line.exclude >second
+if ! diff first second; then
+    echo "the cached search found another ddmin"
+    exit 1
+fi
+
+VFC_BACKENDS="libinterflop_mca.so -m mca --precision-binary64=53 --seed=43" search
+check_samples "changed environment"
+
+# The entries of the first environment are kept
+search
+check_runs 1 "restored environment"
+
+# Same lines, other binary
+verificarlo-c --ddebug -O0 -g archimedes.c -o archimedes -lm --inst-fma -DN_ITER=24
+search
+check_samples "changed binary"
+
+echo "success !"
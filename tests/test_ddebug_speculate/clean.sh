@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ archimedes dd.line sequential speculative rejected.log test.log *.o .*.o
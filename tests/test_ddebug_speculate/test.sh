@@ -0,0 +1,48 @@
+#!/bin/bash
+#
+# Checks that early stopping (INTERFLOP_DD_CONFIDENCE/FAILURE_RATE) and
+# speculative subset testing (INTERFLOP_DD_SPECULATE) reach the same ddmin as
+# a sequential search. The seed is fixed, so that every configuration has the
+# same outcome in both searches.
+
+set -e
+
+export VFC_BACKENDS_LOGGER=False
+export VFC_BACKENDS="libinterflop_mca.so -m mca --precision-binary64=53 --seed=42"
+export INTERFLOP_DD_NRUNS=20
+
+./clean.sh
+
+# Early stopping needs both variables, in ]0,1[
+for setting in "INTERFLOP_DD_CONFIDENCE=0.95" "INTERFLOP_DD_FAILURE_RATE=0.2" \
+    "INTERFLOP_DD_CONFIDENCE=1 INTERFLOP_DD_FAILURE_RATE=0.2" \
+    "INTERFLOP_DD_CONFIDENCE=0.95 INTERFLOP_DD_FAILURE_RATE=0"; do
+    if env $setting vfc_ddebug ddRun ddCmp >rejected.log; then
+        echo "$setting was accepted"
+        exit 1
+    fi
+    grep -q "^Error : INTERFLOP_DD_" rejected.log
+done
+
+verificarlo-c --ddebug -O0 -g archimedes.c -o archimedes -lm --inst-fma
+
+vfc_ddebug ddRun ddCmp
+sort dd.line/rddmin-cmp/dd.line.exclude >sequential
+rm -rf dd.line
+
+INTERFLOP_DD_SPECULATE=4 INTERFLOP_DD_NUM_THREADS=2 \
+    INTERFLOP_DD_CONFIDENCE=0.95 INTERFLOP_DD_FAILURE_RATE=0.2 \
+    vfc_ddebug ddRun ddCmp
+sort dd.line/rddmin-cmp/dd.line.exclude >speculative
+
+if ! grep -q "archimedes.c:16" sequential; then
+    echo "missing line 16 (round-off)"
+    exit 1
+fi
+
+if ! diff sequential speculative; then
+    echo "speculative search found another ddmin"
+    exit 1
+fi
+
+echo "success !"
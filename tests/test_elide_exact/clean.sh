@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ test *.ll .*.ll *.o .*.o log exact rounded
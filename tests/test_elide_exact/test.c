@@ -0,0 +1,18 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Exact in IEEE arithmetic, elided by --elide-exact-ops */
+double twice(double x) { return x * 2.0; }
+double quarter(double x) { return x / 4.0; }
+double plus_zero(double x) { return x + 0.0; }
+double negate(double x) { return -0.0 - x; }
+
+/* Rounded, still instrumented */
+double thrice(double x) { return x * 3.0; }
+
+int main(int argc, char *argv[]) {
+  double x = strtod(argv[1], NULL);
+  printf("%a %a %a %a\n", twice(x), quarter(x), plus_zero(x), negate(x));
+  fprintf(stderr, "%a\n", thrice(x));
+  return 0;
+}
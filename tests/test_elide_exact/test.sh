@@ -0,0 +1,32 @@
+#!/bin/bash
+
+set -e
+
+# -O0 keeps the operations as written
+verificarlo-c -O0 test.c -o test --elide-exact-ops --inst-stats --no-cache 2>log
+
+if ! grep -q "test.c: 1 operations instrumented, 4 exact operations elided" log; then
+    echo "wrong number of elided operations:"
+    cat log
+    exit 1
+fi
+
+export VFC_BACKENDS="libinterflop_mca.so"
+export VFC_BACKENDS_LOGGER="False"
+
+rm -f exact rounded
+for i in {1..20}; do
+    ./test 0.1 >>exact 2>>rounded
+done
+
+if [[ $(sort -u exact | wc -l) != 1 ]]; then
+    echo "exact operations perturbed"
+    exit 1
+fi
+
+if [[ $(sort -u rounded | wc -l) == 1 ]]; then
+    echo "rounded operation not perturbed"
+    exit 1
+fi
+
+echo "test passed"
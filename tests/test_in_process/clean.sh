@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ test_chain test_in_process output_* test.log *.o .*.o
@@ -0,0 +1,21 @@
+#include <stdio.h>
+
+#define N 1000
+
+double x[N], y[N];
+
+int main(void) {
+  for (int i = 0; i < N; i++) {
+    x[i] = 1.0 / (i + 1);
+    y[i] = x[i] * x[i] - 0.1;
+  }
+
+  double sum = 0.0, dot = 0.0;
+  for (int i = 0; i < N; i++) {
+    sum += x[i];
+    dot += x[i] * y[i];
+  }
+
+  printf("%a %a\n", sum, dot);
+  return 0;
+}
@@ -0,0 +1,34 @@
+#!/bin/bash
+#
+# Checks that a program instrumented within clang (--in-process) computes the
+# same results as one instrumented by the clang, opt and clang chain
+
+set -e
+
+export VFC_BACKENDS_LOGGER="False"
+
+verificarlo-c -O2 test.c -o test_chain --no-cache
+verificarlo-c -O2 test.c -o test_in_process --in-process --no-cache
+
+for backend in "libinterflop_ieee.so" \
+    "libinterflop_mca.so --mode=mca --precision-binary64=30 --seed=42"; do
+    VFC_BACKENDS="$backend" ./test_chain >output_chain
+    VFC_BACKENDS="$backend" ./test_in_process >output_in_process
+
+    if ! diff output_chain output_in_process; then
+        echo "different results with $backend"
+        exit 1
+    fi
+done
+
+# The instrumentation is not skipped
+VFC_BACKENDS="libinterflop_mca.so --mode=mca --precision-binary64=30" \
+    ./test_in_process >output_1
+VFC_BACKENDS="libinterflop_mca.so --mode=mca --precision-binary64=30" \
+    ./test_in_process >output_2
+if diff output_1 output_2 >/dev/null; then
+    echo "--in-process build is not instrumented"
+    exit 1
+fi
+
+echo "test passed"
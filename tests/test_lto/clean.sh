@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ output* error test test_jobs test_shared test_archive test.log *.o *.a *.so .vfcwrapper* vfclto.*
@@ -0,0 +1 @@
+double f(double z) { return z - 1.111111111112; }
@@ -0,0 +1 @@
+double g(double z) { return z - 1.111111111112; }
@@ -0,0 +1,12 @@
+#include <stdio.h>
+
+double f(double z);
+double g(double z);
+
+int main(void) {
+  double z = 1.111111111111;
+  double r1 = f(z);
+  printf("%a\n", r1);
+  double r2 = g(z);
+  fprintf(stderr, "%a\n", r2);
+}
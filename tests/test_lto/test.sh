@@ -0,0 +1,48 @@
+#!/bin/bash
+
+set -e
+
+export VFC_BACKENDS="libinterflop_mca.so --precision-binary64 40"
+
+check_outputs() {
+    ./$1 >outputf1 2>outputg1
+    ./$1 >outputf2 2>outputg2
+
+    if diff outputf1 outputf2 >/dev/null; then
+        echo "$1: f output should differ"
+        exit 1
+    fi
+
+    if ! diff outputg1 outputg2 >/dev/null; then
+        echo "$1: g output should be the same"
+        exit 1
+    fi
+}
+
+# Each translation unit is compiled to bitcode, and the program is
+# instrumented as a whole when linking
+for src in f g test; do
+    verificarlo-c --lto -c $src.c -o $src.o
+done
+
+verificarlo-c --lto --function=f test.o f.o g.o -o test
+check_outputs test
+
+# Partitions compiled in parallel
+verificarlo-c --lto --function=f -j 2 test.o f.o g.o -o test_jobs
+check_outputs test_jobs
+
+# Shared libraries need position independent partitions
+verificarlo-c --lto --function=f -shared f.o g.o -o libfg.so
+verificarlo-c test.c -L. -lfg -Wl,-rpath,. -o test_shared
+check_outputs test_shared
+
+# Archive members are not instrumented, the link is rejected
+ar rc libfg.a f.o g.o
+if verificarlo-c --lto test.o libfg.a -o test_archive 2>error; then
+    echo "archive with bitcode members accepted"
+    exit 1
+fi
+grep -q "bitcode members" error
+
+echo "test passed"
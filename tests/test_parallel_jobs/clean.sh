@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ source*.c j1 j4
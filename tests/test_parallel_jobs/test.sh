@@ -0,0 +1,76 @@
+#!/bin/bash
+#
+# Checks that the sources of one invocation compiled in parallel (-j N) give
+# the same objects as a sequential compilation (-j 1), and that a failing
+# source stops the compilation with the same exit code and diagnostics
+
+set -e
+
+sources=""
+for i in $(seq 1 8); do
+    cat >source$i.c <<EOS
+double f$i(double x, double y) { return x * y + $i.0 / (x - y); }
+EOS
+    sources="$sources source$i.c"
+done
+
+# Compiles the sources with $1 jobs, and moves their objects, exit code and
+# diagnostics to j$1. The object cache is disabled, so that every object is
+# compiled
+compile() {
+    local jobs=$1
+    rm -rf j$jobs source*.o
+    mkdir j$jobs
+    set +e
+    verificarlo-c --no-cache -j $jobs -c $sources 2>j$jobs/stderr
+    echo $? >j$jobs/status
+    set -e
+    mv source*.o j$jobs 2>/dev/null || true
+}
+
+compile 1
+compile 4
+
+for i in $(seq 1 8); do
+    if ! cmp j1/source$i.o j4/source$i.o; then
+        echo "source$i.o differs between -j 1 and -j 4"
+        exit 1
+    fi
+done
+if [[ $(cat j4/status) != 0 ]]; then
+    echo "the parallel compilation failed"
+    cat j4/stderr
+    exit 1
+fi
+
+# source3 does not compile: the sources before it are compiled, and the error
+# is reported once, as in a sequential compilation
+echo "double f3(double x) { return x +; }" >source3.c
+compile 1
+compile 4
+
+for jobs in 1 4; do
+    if [[ $(cat j$jobs/status) != 1 ]]; then
+        echo "-j $jobs: exit code $(cat j$jobs/status) instead of 1"
+        exit 1
+    fi
+    if [[ ! -f j$jobs/source1.o || ! -f j$jobs/source2.o || -f j$jobs/source3.o ]]; then
+        echo "-j $jobs: unexpected objects"
+        ls j$jobs
+        exit 1
+    fi
+    if [[ $(grep -c "error: expected expression" j$jobs/stderr) != 1 ]] ||
+        ! grep -q "command failed" j$jobs/stderr; then
+        echo "-j $jobs: unexpected diagnostics"
+        cat j$jobs/stderr
+        exit 1
+    fi
+done
+# the failing command writes to a temporary file with a random name
+if ! diff <(sed -E 's/\.[a-z0-9_]{8}\./.tmp./g' j1/stderr) \
+    <(sed -E 's/\.[a-z0-9_]{8}\./.tmp./g' j4/stderr); then
+    echo "the diagnostics differ between -j 1 and -j 4"
+    exit 1
+fi
+
+echo "test passed"
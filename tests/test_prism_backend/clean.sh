@@ -1,3 +1,3 @@
 #!/bin/bash
 
-rm -Rf *~ .objects .bin .results *.ll *.bc *.vfcwrapper*
+rm -Rf *~ .objects .bin .results test_chunks test_chunks.o *.ll *.bc *.vfcwrapper*
@@ -57,6 +57,9 @@ for mode in up-down sr; do
     run $mode "Test vector dynamic dispatch -march=native" test_vector.sh $DYNAMIC $NATIVE
     run $mode "Test vector static dispatch -march=native" test_vector.sh $STATIC $NATIVE
 
+    # BY-VALUE CHUNKS TESTS
+    run $mode "Test vector by-value chunks -mavx2" test_chunks.sh
+
 done
 
 exit 0
@@ -0,0 +1,57 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#define SIZE 8
+
+using double8 = __attribute__((__vector_size__(SIZE * sizeof(double)))) double;
+
+// <8 x double> operations, wider than the AVX2 registers, split by the PRISM
+// instrumentation in by-value calls on <4 x double> chunks
+#define define_kernel(name, op)                                                \
+  extern "C" __attribute__((noinline)) void kernel_##name(                     \
+      const double *x, const double *y, double *z) {                           \
+    double8 a, b;                                                              \
+    std::memcpy(&a, x, sizeof(a));                                             \
+    std::memcpy(&b, y, sizeof(b));                                             \
+    double8 c = a op b;                                                        \
+    std::memcpy(z, &c, sizeof(c));                                             \
+  }
+
+define_kernel(add, +);
+define_kernel(sub, -);
+define_kernel(mul, *);
+define_kernel(div, /);
+
+// Check that each lane is a rounding of the result computed in long double,
+// which is not instrumented
+#define check_kernel(name, op)                                                 \
+  do {                                                                         \
+    double z[SIZE];                                                            \
+    kernel_##name(x, y, z);                                                    \
+    for (int i = 0; i < SIZE; i++) {                                           \
+      const double ref = (long double)x[i] op(long double) y[i];              \
+      if (z[i] < std::nextafter(ref, -INFINITY) or                             \
+          z[i] > std::nextafter(ref, INFINITY)) {                              \
+        std::printf("kernel_%s lane %d: %a instead of %a\n", #name, i, z[i],  \
+                    ref);                                                      \
+        status = 1;                                                            \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+
+int main() {
+  // distinct lanes, so that misplaced chunks are detected
+  double x[SIZE], y[SIZE];
+  for (int i = 0; i < SIZE; i++) {
+    x[i] = 1.0 + (i + 1) * 0x1p-5 + (i + 1) * 0x1p-40;
+    y[i] = 3.0 + (i + 1) * 0x1p-4 + (i + 1) * 0x1p-44;
+  }
+
+  int status = 0;
+  check_kernel(add, +);
+  check_kernel(sub, -);
+  check_kernel(mul, *);
+  check_kernel(div, /);
+  return status;
+}
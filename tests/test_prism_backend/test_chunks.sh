@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+# Checks that <8 x double> operations compiled for AVX2 are split in by-value
+# calls on <4 x double> chunks instead of going through allocas, and that the
+# results are still correct
+
+set -e
+
+if [[ $(arch) != "x86_64" ]]; then
+    echo "this test is only run on x86_64"
+    exit 0
+fi
+
+if [[ "$PRISM_BACKEND" != "up-down" && "$PRISM_BACKEND" != "sr" ]]; then
+    echo "Error: PRISM_BACKEND must be set to 'up-down' or 'sr'"
+    exit 1
+fi
+
+rm -f test_chunks.*.ll
+
+verificarlo-c++ -O2 -mavx2 -Wno-psabi --prism-backend=${PRISM_BACKEND} \
+    --save-temps -c test_chunks.cpp -o test_chunks.o
+verificarlo-c++ test_chunks.o -o test_chunks --prism-backend=${PRISM_BACKEND} -lm
+
+ir=$(ls test_chunks.*.2.ll)
+
+for op in add sub mul div; do
+    kernel=$(sed -n "/^define .*@kernel_${op}(/,/^}/p" $ir)
+
+    if [[ -z $kernel ]]; then
+        echo "kernel_${op} not found in $ir"
+        exit 1
+    fi
+
+    calls=$(grep -c "call .*fixed8${op}f64x4" <<<"$kernel" || true)
+    if [[ $calls != 2 ]]; then
+        echo "kernel_${op}: expected 2 by-value calls on <4 x double>, found $calls"
+        echo "$kernel"
+        exit 1
+    fi
+
+    if ! grep -q "prism_chunk" <<<"$kernel" || ! grep -q "prism_concat" <<<"$kernel"; then
+        echo "kernel_${op}: operands are not split in chunks"
+        echo "$kernel"
+        exit 1
+    fi
+
+    if grep -q "alloca\|f64x8" <<<"$kernel"; then
+        echo "kernel_${op}: operation passed by pointer"
+        echo "$kernel"
+        exit 1
+    fi
+done
+
+if grep -q avx2 /proc/cpuinfo; then
+    export VFC_BACKENDS_LOGGER=False
+    export VFC_BACKENDS="libinterflop_prism.so"
+    for i in $(seq 1 10); do
+        ./test_chunks
+    done
+else
+    echo "AVX2 is not supported, the results are not checked"
+fi
+
+exit 0
@@ -0,0 +1,12 @@
+double f1(double x, double y) {
+  return x+y;
+}
+double f2(double x, double y) {
+  return x*y;
+}
+double g1(double x, double y) {
+  return x-y;
+}
+double g2(double x, double y) {
+  return x/y;
+}
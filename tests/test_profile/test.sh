@@ -0,0 +1,58 @@
+#!/bin/bash
+# Checks that --profile only instruments the source lines it selects, and that
+# malformed profiles are rejected
+
+set -e
+
+# Print the functions of a verbose compilation log that have instrumented
+# operations
+instrumented() {
+    awk '/^In Function: / { f = $3 } /^Instrumenting/ { print f }' $1 | sort -u | tr '\n' ' '
+}
+
+check() {
+    if [ "$(instrumented $1)" != "$2" ]; then
+        echo "instrumented functions: '$(instrumented $1)', expected '$2'"
+        exit 1
+    fi
+    echo "instrumented functions: $2"
+}
+
+./clean.sh
+
+echo "Test the lines of a profile, relative or absolute"
+cat >profile.txt <<HERE
+# count file:line[:column]
+100 a.c:2
+10 $PWD/a.c:8:12
+
+50 a.c:2:7
+HERE
+verificarlo-c --verbose -c --profile profile.txt a.c -o a.o 2>log
+check log "f1 g1 "
+
+echo "Test --profile-top"
+verificarlo-c --verbose -c --profile profile.txt --profile-top 1 a.c -o a.o 2>log
+check log "f1 "
+
+echo "Test --profile-cold"
+verificarlo-c --verbose -c --profile profile.txt --profile-top 1 --profile-cold a.c -o a.o 2>log
+check log "g1 "
+
+echo "Test a profile of another file"
+echo "100 b.c:2" >other.txt
+verificarlo-c --verbose -c --profile other.txt a.c -o a.o 2>log
+check log ""
+
+for line in "a.c:2" "100 a.c" "100 a.c:" "100 a.c:x" "100 a.c:2:" "100 a.c:2:x" \
+    "100 :2" "x a.c:2" "100 a.c:0"; do
+    echo "Test the malformed line '$line'"
+    echo "$line" >malformed.txt
+    if verificarlo-c -c --profile malformed.txt a.c -o a.o 2>log; then
+        echo "the profile should have been rejected"
+        exit 1
+    fi
+    grep "Syntax error in profile file malformed.txt:1" log
+done
+
+echo "SUCCESS"
@@ -0,0 +1,102 @@
+# Checks that vfc_ci keeps every value of the probes by default, and bounds the
+# error of the metrics computed when their values are sampled (--max-samples)
+
+import sys
+
+import numpy as np
+import pandas as pd
+
+from verificarlo.ci.test_data_processing import ProbesStatistics, data_processing
+
+nb_runs = 20000
+max_samples = 500
+
+# Largest error allowed on the rank of a sampled quantile, and on the
+# significant digits computed from a sample (in bits)
+max_rank_error = 0.02
+max_digits_error = 1.0
+
+rng = np.random.default_rng(42)
+values = {
+    "normal": 1.0 + 1e-6 * rng.standard_normal(nb_runs),
+    "uniform": 1.0 + 1e-6 * rng.uniform(-1, 1, nb_runs),
+    "lognormal": rng.lognormal(0, 0.5, nb_runs),
+}
+
+
+def reduce(statistics):
+    # Runs are added by batches, a probe recorded several times in a run
+    # contributing all its values
+    batch = 1000
+    names = np.repeat(list(values), batch)
+    checks = pd.DataFrame(
+        {"accuracy_threshold": 0.0, "check_mode": ["none"] * len(names)}
+    )
+    for start in range(0, nb_runs, batch):
+        run_data = pd.DataFrame(
+            {
+                "test": "test",
+                "variable": names,
+                "vfc_backend": "libinterflop_mca.so",
+                "values": np.concatenate(
+                    [v[start : start + batch] for v in values.values()]
+                ),
+            }
+        )
+        statistics.add(run_data, checks)
+    return data_processing(statistics.to_dataframe())
+
+
+failures = 0
+
+
+def check(condition, message):
+    global failures
+    if not condition:
+        print("FAILURE:", message)
+        failures += 1
+
+
+exact = reduce(ProbesStatistics())
+sampled = reduce(ProbesStatistics(max_samples=max_samples))
+
+for variable, v in values.items():
+    e = exact.loc[("test", variable, "libinterflop_mca.so")]
+    s = sampled.loc[("test", variable, "libinterflop_mca.so")]
+
+    # By default, nothing is sampled and the quantiles are exact
+    check(e["nsamples_used"] == nb_runs, "%s: values sampled by default" % variable)
+    for q in [25, 50, 75]:
+        check(
+            e["quantile%d" % q] == np.quantile(v, q / 100),
+            "%s: quantile%d not exact by default" % (variable, q),
+        )
+
+    check(s["nsamples"] == nb_runs, "%s: nsamples" % variable)
+    check(s["nsamples_used"] == max_samples, "%s: nsamples_used" % variable)
+
+    # Moments and extrema are computed online from every value
+    for column in ["mu", "sigma", "min", "max"]:
+        check(
+            np.isclose(s[column], e[column], rtol=1e-12),
+            "%s: %s differs when sampling" % (variable, column),
+        )
+
+    # Sketched quantiles are within the rank error of the exact ones
+    for q in [25, 50, 75]:
+        rank = np.mean(v <= s["quantile%d" % q])
+        check(
+            abs(rank - q / 100) < max_rank_error,
+            "%s: quantile%d has rank %f" % (variable, q, rank),
+        )
+
+    for column in ["s2", "s2_lower_bound"]:
+        check(
+            abs(s[column] - e[column]) < max_digits_error,
+            "%s: %s is %f when sampling, %f otherwise"
+            % (variable, column, s[column], e[column]),
+        )
+
+if failures != 0:
+    sys.exit(1)
+print("SUCCESS")
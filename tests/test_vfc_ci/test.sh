@@ -7,6 +7,8 @@ export VFC_BACKENDS_LOGGER="False"
 
 vfc_ci test
 
+python3 check_sampling.py
+
 if ls *.vfcrun.h5; then
     echo "Run file found, SUCCESS"
     exit 0
@@ -0,0 +1,3 @@
+#!/bin/sh
+
+rm -f test test_reopen *.o *.csv output error .vfcwrapper*
@@ -0,0 +1,42 @@
+// Streams probes recorded by several threads and checks that every record
+// reaches the output file
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "vfc_probes.h"
+
+#define NB_THREADS 4
+#define NB_STEPS 10000
+
+vfc_probes probes;
+
+void *record(void *arg) {
+  char varName[32];
+  sprintf(varName, "thread_%ld", (long)arg);
+  size_t id = vfc_probe_register(&probes, "stream_test", varName);
+
+  double x = 0.0;
+  for (int i = 0; i < NB_STEPS; i++) {
+    x += 0.1;
+    vfc_probe_id(&probes, id, x);
+  }
+  return NULL;
+}
+
+int main(void) {
+  probes = vfc_init_probes();
+
+  pthread_t threads[NB_THREADS];
+  for (long i = 0; i < NB_THREADS; i++) {
+    pthread_create(&threads[i], NULL, record, (void *)i);
+  }
+  for (int i = 0; i < NB_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  printf("%u\n", vfc_num_probes(&probes));
+  vfc_dump_probes(&probes);
+
+  return 0;
+}
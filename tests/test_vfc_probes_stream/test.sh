@@ -0,0 +1,51 @@
+#!/bin/bash
+set -e
+
+export VFC_BACKENDS="libinterflop_ieee.so"
+export VFC_BACKENDS_SILENT_LOAD="True"
+export VFC_BACKENDS_LOGGER="False"
+
+verificarlo-c test.c -lvfc_probes -pthread -o test
+
+# Time series: the same probe is recorded at every step
+VFC_PROBES_STREAM="True" VFC_PROBES_CHECK_DUPLICATES="False" \
+    VFC_PROBES_STREAM_CHUNK=4096 VFC_PROBES_OUTPUT="stream.csv" ./test >output
+
+if [[ $(cat output) != 40000 ]]; then
+    echo "wrong number of probes: $(cat output), FAILURE"
+    exit 1
+fi
+
+# header + one line per record, no line was split or interleaved
+if [[ $(wc -l <stream.csv) != 40001 ]]; then
+    echo "wrong number of lines in stream.csv, FAILURE"
+    exit 1
+fi
+if [[ $(grep -c -E '^stream_test,thread_[0-3],[^,]+,[^,]+,none$' stream.csv) != 40000 ]]; then
+    echo "malformed records in stream.csv, FAILURE"
+    exit 1
+fi
+
+# Duplicate detection is on by default and rejects the time series
+if VFC_PROBES_STREAM="True" VFC_PROBES_OUTPUT="stream.csv" ./test 2>error; then
+    echo "duplicate probes not detected, FAILURE"
+    exit 1
+fi
+grep -q "duplicate" error
+
+# A second stream, opened once the first one is closed, is not mistaken for
+# the first one by the threads that recorded probes in both
+verificarlo-c -fopenmp=libomp test_reopen.c -lvfc_probes -o test_reopen
+VFC_PROBES_STREAM="True" VFC_PROBES_CHECK_DUPLICATES="False" \
+    VFC_PROBES_STREAM_CHUNK=4096 VFC_PROBES_OUTPUT="reopen.csv" ./test_reopen >output
+
+if [[ $(cat output) != $'40000\n40000' ]]; then
+    echo "wrong number of probes after reopening: $(cat output), FAILURE"
+    exit 1
+fi
+if [[ $(grep -c -E '^reopen_test,thread_[0-3],[^,]+,[^,]+,none$' reopen.csv) != 40000 ]]; then
+    echo "malformed records in reopen.csv, FAILURE"
+    exit 1
+fi
+
+echo "SUCCESS"
@@ -0,0 +1,34 @@
+// Opens and closes the probes stream twice from the threads of an OpenMP
+// pool, which keep their buffer caches from the first stream to the second
+
+#include <omp.h>
+#include <stdio.h>
+
+#include "vfc_probes.h"
+
+#define NB_ROUNDS 2
+#define NB_STEPS 10000
+
+int main(void) {
+  for (int round = 0; round < NB_ROUNDS; round++) {
+    vfc_probes probes = vfc_init_probes();
+
+#pragma omp parallel num_threads(4)
+    {
+      char varName[32];
+      sprintf(varName, "thread_%d", omp_get_thread_num());
+      size_t id = vfc_probe_register(&probes, "reopen_test", varName);
+
+      double x = 0.0;
+      for (int i = 0; i < NB_STEPS; i++) {
+        x += 0.1;
+        vfc_probe_id(&probes, id, x);
+      }
+    }
+
+    printf("%u\n", vfc_num_probes(&probes));
+    vfc_dump_probes(&probes);
+  }
+
+  return 0;
+}
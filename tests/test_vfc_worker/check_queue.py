@@ -0,0 +1,133 @@
+# Runs jobs through several vfc_worker processes sharing a queue directory,
+# and checks that every job runs once, that jobs can be cancelled before and
+# while running, that the jobs of a dead worker are requeued, and that a
+# stalled worker does not report the status of a requeued job
+
+import os
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+from verificarlo import executor
+
+nb_workers = 3
+nb_jobs = 30
+
+
+def start_workers(directory, count):
+    return [
+        subprocess.Popen(["vfc_worker", directory, "--idle-timeout", "5"])
+        for _ in range(count)
+    ]
+
+
+def stop_workers(workers):
+    for worker in workers:
+        worker.wait(timeout=60)
+
+
+def check(condition, message):
+    if not condition:
+        print("%s, FAILURE" % message)
+        sys.exit(1)
+
+
+def wait_for(path, timeout=30):
+    deadline = time.monotonic() + timeout
+    while not os.path.exists(path):
+        check(time.monotonic() < deadline, "%s never appeared" % path)
+        time.sleep(executor.poll_interval)
+
+
+def test_run_once(directory):
+    queue = executor.QueueExecutor(directory)
+    workers = start_workers(directory, nb_workers)
+
+    jobs = [
+        queue.submit(["sh", "-c", "echo %d >>runs.log; sleep 0.1" % i])
+        for i in range(nb_jobs)
+    ]
+    returncodes = [job.wait(timeout=120) for job in jobs]
+    check(all(r == 0 for r in returncodes), "failed jobs: %s" % returncodes)
+
+    with open("runs.log") as f:
+        runs = sorted(int(line) for line in f)
+    check(runs == list(range(nb_jobs)), "jobs not run exactly once: %s" % runs)
+
+    # Cancel a job claimed by a worker
+    job = queue.submit(["sleep", "60"])
+    wait_for(job.path(".lock"))
+    start = time.monotonic()
+    job.kill()
+    check(job.wait(timeout=30) != 0, "killed job succeeded")
+    check(time.monotonic() - start < 30, "running job not killed")
+
+    stop_workers(workers)
+    check(os.listdir(directory) == [], "files left in the queue")
+
+
+def test_kill_unclaimed(directory):
+    queue = executor.QueueExecutor(directory)
+    job = queue.submit(["touch", "unclaimed_ran"])
+    job.kill()
+    check(job.returncode == executor.killed_returncode, "unclaimed job not killed")
+
+    stop_workers(start_workers(directory, 1))
+    check(not os.path.exists("unclaimed_ran"), "cancelled job ran")
+    check(os.listdir(directory) == [], "files left in the queue")
+
+
+def test_stale_lock(directory):
+    queue = executor.QueueExecutor(directory)
+    job = queue.submit(["touch", "stale_ran"])
+
+    # A worker claimed the job and died
+    with open(job.path(".lock"), "w") as f:
+        f.write("dead-worker 0\n")
+
+    executor.stale_timeout = 1
+    workers = start_workers(directory, 1)
+    check(job.wait(timeout=60) == 0, "stale job not requeued")
+    check(os.path.exists("stale_ran"), "stale job did not run")
+    stop_workers(workers)
+
+
+def test_stalled_worker(directory):
+    queue = executor.QueueExecutor(directory)
+    # The first run fails after 6 seconds, while the second one, started when
+    # the lock goes stale after 4 seconds, succeeds after 3 seconds
+    job = queue.submit(
+        [
+            "sh",
+            "-c",
+            "if [ -e stalled_ran ]; then sleep 3; else touch stalled_ran; "
+            "sleep 6; exit 1; fi",
+        ]
+    )
+
+    # A worker claims the job and stops touching its lock while running it
+    executor.stale_timeout = 4
+    executor.heartbeat_interval = 60
+    job_id, token = executor.claim_job(directory)
+    check(job_id == job.job_id, "job not claimed")
+    stalled = threading.Thread(target=executor.run_job, args=(directory, job_id, token))
+    stalled.start()
+
+    workers = start_workers(directory, 1)
+    check(job.wait(timeout=60) == 0, "status of the stalled worker reported")
+    stalled.join()
+    stop_workers(workers)
+    check(
+        not os.path.exists(job.path(".status")), "status of the stalled worker written"
+    )
+
+
+with tempfile.TemporaryDirectory(dir=".") as tmp:
+    test_run_once(os.path.join(tmp, "queue"))
+    test_kill_unclaimed(os.path.join(tmp, "unclaimed"))
+    test_stale_lock(os.path.join(tmp, "stale"))
+    test_stalled_worker(os.path.join(tmp, "stalled"))
+
+print("SUCCESS")
@@ -0,0 +1,3 @@
+#!/bin/sh
+
+rm -rf runs.log unclaimed_ran stale_ran stalled_ran tmp*
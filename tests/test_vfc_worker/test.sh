@@ -0,0 +1,6 @@
+#!/bin/sh
+
+set -e
+
+./clean.sh
+python3 check_queue.py
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+rm -Rf *~ cache *.o *.log concurrent1 concurrent2 cached changed rebuilt
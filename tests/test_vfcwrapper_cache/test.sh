@@ -0,0 +1,69 @@
+#!/bin/bash
+#
+# Checks the cache of the vfcwrapper variants: concurrent compilations on an
+# empty cache build each variant once, and a change of a dependency of the
+# wrapper rebuilds it
+
+set -e
+
+export VFC_CACHE_DIR=$PWD/cache
+rm -rf $VFC_CACHE_DIR
+
+# Number of vfcwrapper compilations in the --show-cmd logs given
+wrapper_builds() {
+    cat "$@" | grep "vfcwrapper.c" | grep -c -- "-MD -MF" || true
+}
+
+check_builds() {
+    if [[ $1 != $2 ]]; then
+        echo "$3: the vfcwrapper was compiled $1 times instead of $2"
+        exit 1
+    fi
+}
+
+# Two concurrent compilations, the second one waits on the lock of the
+# variants the first one is building
+verificarlo-c test.c -o concurrent1 --show-cmd &>concurrent1.log &
+pid1=$!
+verificarlo-c test.c -o concurrent2 --show-cmd &>concurrent2.log &
+pid2=$!
+wait $pid1
+wait $pid2
+
+variants=$(ls $VFC_CACHE_DIR/vfcwrapper | wc -l)
+check_builds $(wrapper_builds concurrent1.log concurrent2.log) $variants \
+    "concurrent compilations"
+
+# Entries only hold the wrapper, its dependencies and the lock, without
+# temporary files left by the concurrent compilations
+for entry in $VFC_CACHE_DIR/vfcwrapper/*; do
+    if [[ $(ls $entry | grep -v -x -e "vfcwrapper\..*" -e deps -e lock) != "" ]] ||
+        [[ $(ls $entry | wc -l) != 3 ]]; then
+        echo "unexpected files in $entry:"
+        ls $entry
+        exit 1
+    fi
+done
+
+for program in concurrent1 concurrent2; do
+    if [[ $(./$program) != "0.3" ]]; then
+        echo "$program does not run"
+        exit 1
+    fi
+done
+
+verificarlo-c test.c -o cached --show-cmd &>cached.log
+check_builds $(wrapper_builds cached.log) 0 "cached variants"
+
+# A header of the wrapper changed since its variants were built: the
+# recorded signature of its first dependency no longer matches
+for entry in $VFC_CACHE_DIR/vfcwrapper/*; do
+    sed -i '1s/ [0-9]*$/ 0/' $entry/deps
+done
+verificarlo-c test.c -o changed --show-cmd &>changed.log
+check_builds $(wrapper_builds changed.log) $variants "changed dependency"
+
+verificarlo-c test.c -o rebuilt --show-cmd &>rebuilt.log
+check_builds $(wrapper_builds rebuilt.log) 0 "rebuilt variants"
+
+echo "test passed"